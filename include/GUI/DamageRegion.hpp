@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	/* The parts of the screen that changed during a frame, as a small list
+	 * of rects(in view coordinates, like the widgets' rects). Merging joins
+	 * the rects that overlap or are close enough that drawing their union
+	 * costs about the same, and too many rects end up as their bounds.
+	 */
+	class DamageRegion
+	{
+	public:
+		DamageRegion(uint32 maxRects = 8);
+
+		//empty rects are ignored
+		void Add(const Rect& rect);
+		void Add(const DamageRegion& region);
+		void Merge();
+		void Clear();
+
+		bool IsEmpty() const;
+		bool Intersects(const Rect& rect) const;
+
+		const std::vector<Rect>& GetRects() const;
+		Rect GetBounds() const;
+
+		//the area covered by the rects, overlaps counted twice
+		uint32 GetArea() const;
+	private:
+		std::vector<Rect> m_rects;
+		uint32 m_maxRects;			//more rects than this get merged into one
+
+		static uint32 Area(const Rect& rect);
+		static bool ShouldMerge(const Rect& first, const Rect& second);
+	};
+}
@@ -3,6 +3,12 @@
 #include <sfml/System.hpp>
 #include <sfml/Graphics.hpp>
 
+#ifdef _MSC_VER
+	#include <unordered_map>
+#else
+	#include <tr1/unordered_map>
+#endif
+
 namespace gui {
 
 	/* Useful primitive data typedefs */
@@ -14,6 +20,16 @@ namespace gui {
 	typedef sf::Int16   int16;
 	typedef sf::Int8	 int8;
 
+	class Widget;
+
+	/* Name symbol(see SymbolTable) -> widget lookup table used by containers
+	 * for O(1) searches */
+	typedef std::tr1::unordered_map<uint32, Widget*> NameIndex;
+
+	/* Name symbol -> how many more widgets of a container use the name
+	 * without being indexed(they got renamed to a taken name) */
+	typedef std::tr1::unordered_map<uint32, uint32> NameCount;
+
 	enum WidgetType {
 		WIDGET, 
 		BUTTON, 
@@ -50,7 +66,7 @@ namespace gui {
 			OnValueChanged,
 			OnDoubleClick,
 
-			Count
+			Count			//must stay <= 32, the dispatchers keep a bit per type
 		};
 	}
 	enum Alignment {
@@ -120,6 +136,10 @@ namespace gui {
 	bool IsCollision(const Rect& first, const Rect& second);
 	bool IsCollision(const Rect& first, const Rect& second, sf::Vector2f& normal);
 
+	//the overlapping part(an empty rect if none)/the smallest rect containing both
+	Rect GetIntersection(const Rect& first, const Rect& second);
+	Rect GetUnion(const Rect& first, const Rect& second);
+
 	std::string ToUpper(const std::string& text);
 	sf::Color UnsignedToColor(uint32 rgba);
 	uint32 ColorToUnsigned(const sf::Color& color);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Defines.hpp"
+#include "WidgetHandle.hpp"
 
 namespace gui
 {
@@ -83,9 +84,9 @@ namespace gui
 		DropFlags m_forceDragFlags;	//forces the widget to change the drop flags
 		uint32 m_minDragDist;		//the min amount of distance it takes for drag to start
 		
-		gui::Widget* m_target;		//the widget being dragged
-		gui::Widget* m_targetParent;//the target's parent, if any.. do I need it ?
-		gui::Widget* m_focusTarget;	//the *appropriate* widget over which the mouse hovers
+		WidgetHandle m_target;		//the widget being dragged
+		WidgetHandle m_targetParent;//the target's parent, if any.. do I need it ?
+		WidgetHandle m_focusTarget;	//the *appropriate* widget over which the mouse hovers
 
 		bool m_forceMove;			//forces any widget to move irregardless of flags
 		bool m_stopped;				//if stopped, the drag will be deleted at next update
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "RenderBackend.hpp"
+
+namespace gui
+{
+	/* Command buffer the widgets draw into during a frame. Rectangles 
+	 * (plain sf::Shape quads) are merged into a single vertex batch as long
+	 * as nothing else is drawn in between and the clip rect doesn't change, 
+	 * so a whole panel of widgets costs one draw call. Other drawables 
+	 * (texts, sprites) are kept in order and drawn as they are, and the 
+	 * scissor test is only touched when the clip rect really changes.
+	 * Outside Begin()/Flush() everything is drawn right away.
+	 */
+	class DrawList
+	{
+	public:
+		class Cache;
+
+		struct Stats {
+			Stats();
+			uint32 commands;		//commands recorded
+			uint32 quads;			//quads recorded
+			uint32 drawCalls;		//submissions to the render window
+			uint32 clipChanges;		//scissor state changes
+			uint32 cachedCommands;	//commands replayed from caches
+		};
+
+		DrawList();
+
+		//starts recording a frame, nothing is drawn until Flush()
+		void Begin(RenderBackend* backend);
+
+		//submits the recorded commands and clears them
+		void Flush();
+		bool IsRecording() const;
+
+		//if not set, every command is drawn right away(the old behaviour)
+		void SetBatching(bool flag);
+		bool IsBatching() const;
+
+		void AddQuad(float x, float y, float w, float h, const sf::Color& color);
+
+		//rectangles without outline, rotation or scale become quads,
+		//anything else is drawn as a drawable
+		void Add(const sf::Shape& shape);
+
+		//the drawable must stay alive until the list is flushed
+		void Add(const sf::Drawable& drawable);
+
+		//scissor rect in window coordinates(like glScissor), intersected 
+		//with the current one, popping restores the previous one
+		void PushClip(const Rect& scissor);
+		void PopClip();
+
+		//everything recorded between the two calls is kept in the cache as
+		//well, the clip pushes/pops in between must be balanced. Nothing is 
+		//kept if the cache starts inside a clip, the rects would be baked in
+		void BeginCache(Cache& cache);
+		void EndCache(Cache& cache);
+
+		//records the cached commands again, the drawables they point to
+		//must still be alive and unchanged
+		void AddCache(const Cache& cache);
+
+		//the stats of the last flushed frame
+		const Stats& GetStats() const;
+	private:
+		typedef ColorVertex Vertex;
+
+		enum CommandType {
+			QuadCommand,			//a range of m_vertices
+			DrawableCommand
+		};
+
+		struct Command {
+			uint8 type;
+			uint32 first, count;			//the vertices, for quads
+			const sf::Drawable* drawable;	//for drawables
+			int32 clip;						//index in m_clips, -1 for no clipping
+		};
+
+		std::vector<Command> m_commands;
+		std::vector<Vertex> m_vertices;
+		std::vector<Rect> m_clips;			//all the clip rects pushed this frame
+		std::vector<int32> m_clipStack;		//indices in m_clips
+		RenderBackend* m_backend;			//where the commands get drawn
+		bool m_recording;
+		bool m_batching;
+		uint32 m_mergeFrom;					//the first command quads can be merged into
+		uint32 m_cacheCommand;				//where the cache being recorded starts
+		uint32 m_cacheVertex;
+		uint32 m_cacheClip;
+		uint32 m_cacheDepth;				//the clip stack depth when the cache started
+		Cache* m_cache;						//the cache being recorded, if any
+		Stats m_stats;						//of the frame being recorded
+		Stats m_lastStats;					//of the last flushed frame
+
+		int32 GetCurrentClip() const;
+		void ApplyClip(int32 clip, int32& applied);
+		void AddVertex(float x, float y, const sf::Color& color);
+		Command& AddCommand(CommandType type);
+	};
+
+	/* The commands recorded while drawing a subtree, so a subtree that 
+	 * didn't change can be drawn again without visiting its widgets.
+	 */
+	class DrawList::Cache
+	{
+	public:
+		Cache();
+
+		//the cache is only valid after a complete recording
+		bool IsValid() const;
+		void Invalidate();
+
+		uint32 GetCommandCount() const;
+	private:
+		friend class DrawList;
+
+		std::vector<Command> m_commands;
+		std::vector<Vertex> m_vertices;
+		std::vector<Rect> m_clips;
+		bool m_valid;
+	};
+}
@@ -1,11 +1,18 @@
 #pragma once
 
 #include "Defines.hpp"
+#include "WidgetHandle.hpp"
+#include "Signal.hpp"
 
 namespace gui 
 {
 
 	class Widget;
+
+	/* Base of all the events sent through the mediators. Events are 
+	 * reference counted and live in per-size pools, so posting them 
+	 * doesn't touch the heap once the pools are warm.
+	 */
 	class Event
 	{
 	public:
@@ -15,8 +22,20 @@ namespace gui
 		uint32 GetType() const;
 		void SetType(uint32 type);
 
+		//the event goes back to its pool when the last reference is released
+		void AddRef();
+		void Release();
+
+		//merges a newer event into this pending one, returns false if they
+		//can't be merged(the default). Used by coalescing listeners
+		virtual bool Coalesce(const Event* newer);
+
+		static void* operator new(size_t size);
+		static void operator delete(void* memory, size_t size);
+
 		uint32 m_refCount;
 		uint32 m_type;
+		float m_timestamp;		//when the input causing it was received, < 0 if unknown
 	};
 
 	class SfmlEvent : public Event
@@ -31,34 +50,51 @@ namespace gui
 	class WidgetEvent : public Event
 	{
 	public:
+		//what the direct signals(see Signal) receive besides the widget
+		typedef NoArgument Argument;
+
 		WidgetEvent(Widget* widget);
 
+		//NULL if the widget was killed or freed before the event got read
 		Widget* GetWidget() const;
 	protected:
-		Widget* m_widget;
+		WidgetHandle m_widget;
+
+		//same event type coming from the same widget
+		bool IsSameSource(const Event* newer) const;
 	};
 
 	class OnClickPressed : public WidgetEvent
 	{
 	public:
+		enum { EventType = sf::Event::MouseButtonPressed };
+
 		OnClickPressed(Widget* widget);
 	};
 
 	class OnClickReleased : public WidgetEvent
 	{
 	public:
+		enum { EventType = sf::Event::MouseButtonReleased };
+
 		OnClickReleased(Widget* widget);
 	};
 
 	class OnDoubleClick : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnDoubleClick };
+
 		OnDoubleClick(Widget* widget);
 	};
 
 	class OnKeyPressed : public WidgetEvent
 	{
 	public:
+		enum { EventType = sf::Event::KeyPressed };
+
+		typedef sf::Event::KeyEvent Argument;
+
 		OnKeyPressed(Widget* widget, sf::Event::KeyEvent key);
 		const sf::Event::KeyEvent& GetKey() const;
 	protected:
@@ -68,6 +104,10 @@ namespace gui
 	class OnKeyReleased : public WidgetEvent 
 	{
 	public:
+		enum { EventType = sf::Event::KeyReleased };
+
+		typedef sf::Event::KeyEvent Argument;
+
 		OnKeyReleased(Widget* widget, sf::Event::KeyEvent key);
 		const sf::Event::KeyEvent& GetKey() const;
 	protected:
@@ -77,44 +117,63 @@ namespace gui
 	class OnFocus : public WidgetEvent 
 	{
 	public:
+		enum { EventType = events::OnFocus };
+
 		OnFocus(Widget* widget);
 	};
 
 	class OnFocusLost : public WidgetEvent 
 	{
 	public:
+		enum { EventType = events::OnFocusLost };
+
 		OnFocusLost(Widget* widget);
 	};
 
 	class OnHover : public WidgetEvent 
 	{
 	public:
+		enum { EventType = events::OnHover };
+
 		OnHover(Widget* widget);
 	};
 
 	class OnHoverLost: public WidgetEvent 
 	{
 	public: 
+		enum { EventType = events::OnHoverLost };
+
 		OnHoverLost(Widget* widget);
 	};
 
 	class OnShow : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnShow };
+
 		OnShow(Widget* widget);
 	};
 
 	class OnHide : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnHide };
+
 		OnHide(Widget* widget);
 	};
 
 	class OnResize : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnResize };
+
+		typedef Rect Argument;		//the old rect
+
 		OnResize(Widget* widget,const Rect& oldRect);
 		const Rect& GetOldRect() const;
+
+		//keeps the first old rect, the new one is the widget's current rect
+		bool Coalesce(const Event* newer);
 	private:
 		Rect m_oldRect;
 	};
@@ -122,23 +181,39 @@ namespace gui
 	class OnDestroy : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnDestroy };
+
 		OnDestroy(Widget* widget);
 	};
 
 	class OnMove : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnMove };
+
+		typedef Rect Argument;		//the old rect
+
 		OnMove(Widget* widget,const Rect& oldRect);
 		const Rect& GetOldRect() const;
+
+		//keeps the first old rect, the new one is the widget's current rect
+		bool Coalesce(const Event* newer);
 	private:
 		Rect m_oldRect;
 	};
 	class OnValueChanged : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnValueChanged };
+
+		typedef int32 Argument;
+
 		OnValueChanged(Widget* widget, int32 value);
 		
 		int32 GetValue() const;
+
+		//keeps the latest value
+		bool Coalesce(const Event* newer);
 	private:
 		int32 m_value;
 	};
@@ -147,8 +222,15 @@ namespace gui
 	class OnDrag : public WidgetEvent
 	{
 	public:
+		enum { EventType = events::OnDrag };
+
+		typedef Drag* Argument;
+
 		OnDrag(Widget* widget, Drag* drag);
 		Drag* GetDrag() const;
+
+		//keeps the latest drag
+		bool Coalesce(const Event* newer);
 	private:
 		Drag* m_drag;
 	};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Defines.hpp"
+#include <map>
+
+namespace gui
+{
+	/* Glyph metrics of a font at one size and style, ready to be turned
+	 * into quads. SFML rasterizes a font once, in a single texture, so the
+	 * texture is shared by all the sizes/styles of the font; what's cached
+	 * here is the scaled, sheared geometry sf::String computes on every
+	 * draw. Atlases are created on first use and live as long as the font,
+	 * one found for a font that got destroyed since is built again.
+	 */
+	class GlyphAtlas
+	{
+	public:
+		struct Glyph {
+			float x[4], y[4];	//quad corners relative to the pen(TL,BL,BR,TR)
+			float advance;		//how much the pen moves after the glyph
+			sf::FloatRect uv;	//texture coordinates inside the font image
+			bool visible;		//false for spaces and control characters
+		};
+
+		//returns the shared atlas, building it if needed
+		static const GlyphAtlas& Get(const sf::Font& font, float size, unsigned long style);
+
+		//drops all the atlases of the font right away, instead of when a
+		//new font at the same address is used
+		static void Release(const sf::Font& font);
+
+		const Glyph& GetGlyph(uint32 codepoint) const;
+		const sf::Image& GetTexture() const;
+		const sf::Font& GetFont() const;
+
+		float GetSize() const;
+		unsigned long GetStyle() const;
+
+		//the height of a line, the pen starts this far below the top
+		float GetLineHeight() const;
+
+		//the bold style draws every glyph 4 more times, slightly offset
+		float GetBoldOffset() const;
+
+		//the underline position below the pen and its thickness
+		float GetUnderlineOffset() const;
+		float GetUnderlineThickness() const;
+	private:
+		struct Key {
+			const sf::Font* font;
+			float size;
+			unsigned long style;
+			bool operator<(const Key& other) const;
+		};
+		typedef std::map<Key, GlyphAtlas*> AtlasList;
+
+		const sf::Font& m_font;
+		sf::ResourcePtr<sf::Font> m_alive;	//reset by SFML when the font is destroyed
+		float m_size;
+		unsigned long m_style;
+		float m_scale;					//requested size / rasterized size
+		Glyph m_glyphs[256];			//the characters TextArea can produce
+		mutable Glyph m_other;			//scratch glyph for everything else
+
+		GlyphAtlas(const sf::Font& font, float size, unsigned long style);
+		void BuildGlyph(uint32 codepoint, Glyph& glyph) const;
+
+		static AtlasList& GetAtlases();
+	};
+
+	/* Cached geometry for a block of text: one textured quad per glyph and
+	 * a plain quad per underline, grouped by font texture. Built once when
+	 * the text or its layout changes, then drawn with one call per font.
+	 */
+	class TextMesh : public sf::Drawable
+	{
+	public:
+		TextMesh();
+
+		//adds the string at its current position, with its color and style
+		void Append(const sf::String& string);
+		//adds the other mesh's glyphs moved by the offset
+		void Append(const TextMesh& mesh, const sf::Vector2f& offset = sf::Vector2f(0.f,0.f));
+		void Clear();
+
+		bool IsEmpty() const;
+		uint32 GetGlyphCount() const;
+	protected:
+		virtual void Render(sf::RenderTarget& target) const;
+	private:
+		friend class SoftwareBackend;
+
+		struct Vertex {
+			float x, y, u, v;
+			sf::Color color;
+		};
+		struct Run {
+			const sf::Image* texture;
+			std::vector<Vertex> glyphs;		//textured quads
+			std::vector<Vertex> lines;		//untextured underline quads
+		};
+
+		std::vector<Run> m_runs;
+
+		Run& GetRun(const sf::Image* texture);
+	};
+}
@@ -5,6 +5,7 @@
 
 namespace gui
 {
+	class DrawList;
 
 	class LayoutItem {
 	public:
@@ -38,7 +39,7 @@ namespace gui
 		void SetWidget(Widget* widget);
 		Widget* GetWidget() const;
 
-		void Draw(sf::RenderWindow& window) const;
+		void Draw(DrawList& drawList) const;
 
 		bool empty() const;
 
@@ -108,7 +109,7 @@ namespace gui
 		void RemoveWidgetFromGrid(Widget* widget);
 		void Draw() const;
 
-		void SetPosForGrid();
+		void SetPosForGrid(bool moveWidgets = true);
 		bool HandleDragStop(Drag* drag);
 
 		bool FindWidgetInGrid(Widget* widget, uint32& line, uint32& column);
@@ -6,6 +6,15 @@
 #include "GuiMgrParser.hpp"
 #include "Mediator.hpp"
 #include "AbstractFactory.hpp"
+#include "WidgetPath.hpp"
+#include "SpatialIndex.hpp"
+#include "WidgetList.hpp"
+#include "WidgetHandle.hpp"
+#include "LatencyStats.hpp"
+#include "DrawList.hpp"
+#include "DamageRegion.hpp"
+#include "RenderBackend.hpp"
+#include "OcclusionBuffer.hpp"
 
 class TiXmlNode;
 
@@ -13,6 +22,7 @@ namespace gui {
 
 	class Widget;
 	class Drag;
+	class InputRecorder;
 
 	class GuiManager 
 	{
@@ -27,19 +37,104 @@ namespace gui {
 
 		void SetWindow(sf::RenderWindow* window);
 		sf::RenderWindow& GetWindow() const;
+
+		//what the widgets draw into, flushed once per Update
+		DrawList& GetDrawList() const;
+
+		//where the drawing ends up, NULL goes back to the window. The window
+		//is still used for its view and input. The backend isn't owned
+		void SetRenderBackend(RenderBackend* backend);
+		RenderBackend& GetRenderBackend() const;
+
+		//if set, every top-level widget keeps the commands it recorded and 
+		//replays them until something inside it gets marked dirty, instead
+		//of drawing its whole subtree every frame. Off by default
+		void SetRetainedMode(bool flag);
+		bool IsRetainedMode() const;
+
+		//forces all the top-level widgets to draw again next frame
+		void InvalidateDrawCaches();
+
+		struct CullStats {
+			CullStats();
+			uint32 occluders;			//opaque top-level widgets found
+			uint32 occludedWidgets;		//top-level widgets skipped, per damage rect with partial redraw
+			uint32 occludedChildren;	//subtrees skipped inside partly hidden widgets
+		};
+
+		//if set, top-level widgets hidden behind opaque top-level widgets in
+		//front of them(see Widget::GetOpaqueRect) aren't drawn, and neither
+		//are the children they have there. Off by default
+		void SetOcclusionCulling(bool flag);
+		bool IsOcclusionCulling() const;
+
+		//of the last update
+		const CullStats& GetCullStats() const;
+
+		//if set, only the damaged parts of the window get drawn again(see
+		//Widget::Repaint), by the widgets touching them and clipped to them.
+		//The window must not be cleared between frames, the damaged parts 
+		//are cleared here. The previous frame's damage is drawn again as 
+		//well, the back buffer is one frame behind. Off by default
+		void SetPartialRedraw(bool flag);
+		bool IsPartialRedraw() const;
+
+		//reports a changed part of the screen, in view coordinates
+		void AddDamage(const Rect& rect);
+		void DamageAll();
+
+		//the merged region drawn by the last update
+		const DamageRegion& GetDrawnDamage() const;
+
+		//what the damaged parts are cleared with
+		void SetClearColor(const sf::Color& color);
+		const sf::Color& GetClearColor() const;
+
 		void RegisterEvent(sf::Event& event);
 
+		//if set, consecutive mouse moves registered in the same frame 
+		//are collapsed into the latest one
+		void SetMouseMoveCoalescing(bool flag);
+		bool IsMouseMoveCoalescing() const;
+
+		//every registered event and update delta gets written to the 
+		//recorder, NULL stops recording. The recorder isn't owned
+		void SetRecorder(InputRecorder* recorder);
+		InputRecorder* GetRecorder() const;
+
+		//timestamps the registered events, so the time until widgets and
+		//listeners handle them is recorded(see LatencyStats). Off by default
+		void SetLatencyTracking(bool flag);
+		bool IsLatencyTracking() const;
+		LatencyStats& GetLatencyStats();
+		const LatencyStats& GetLatencyStats() const;
+
+		//records the time since the timestamp, if tracking and the timestamp is valid
+		void RecordLatency(LatencyStats::Stage stage, uint32 eventType, float timestamp);
+
+		//when the input event being routed was received, < 0 if none
+		float GetRoutedTimestamp() const;
+
+		//the routed event's timestamp, < 0 if not tracking or if no input
+		//event is being routed
+		float GetInputTimestamp() const;
+
 		bool AddWidget(Widget* widget);
 		void AddWidgetForced(Widget* widget);
 
 		void DeleteWidget(const std::string& name);
 		void DeleteWidget(Widget* widget);
 
+		//Removes the widget from management, doesn't free it
+		//returns false if the widget isn't a top-level widget
+		bool RemoveWidget(Widget* widget);
+
 		void Update(float diff);
 		const Mediator& GetMediator() const { return m_mediator; }
 
 		std::vector<Widget*> GetWidgetsByType(WidgetType type) const;
 		Widget* GetWidgetByName(const std::string& name) const;
+		Widget* GetWidgetBySymbol(uint32 nameSymbol) const;
 		Widget* GetWidgetAt(const sf::Vector2f& pos) const;
 		Widget* GetWidgetAt(int x, int y) const;
 
@@ -57,6 +152,7 @@ namespace gui {
 		//if the query fails, the stack will be empty!
 		std::stack<Widget*> QueryWidgetPath(const std::string& path) const;
 		Widget* QueryWidget(const std::string& path) const;
+		Widget* QueryWidget(const WidgetPath& path) const;
 		sf::Vector2f ConvertCoords(int x, int y);
 
 		gui::uint32 GetOldWidth() const;
@@ -68,28 +164,53 @@ namespace gui {
 		void SetHasFocus(Widget* widget);
 	private:
 		friend class GuiMgrParser;
-		typedef std::map<uint32, Widget*> WidgetList;
+		friend class Widget;
 		std::vector<Widget*> m_freeWidgets;	//holds the guids of widgets that will be freed
 		Theme* m_theme;						//the current theme used by widgets
 		WidgetList m_widgets;				//holds the parent widgets
-		uint32 index;						//used to keep track of focusing levels
+		NameIndex m_nameIndex;				//the parent widgets, indexed by name
+		NameCount m_shadowedNames;			//the names more than one parent widget uses
+		SpatialIndex m_spatialIndex;		//the parent widgets, indexed by position
 		std::vector<sf::Event> m_events;	//events queue
-		Widget* m_focus;					//holds the currently focused widget if any
-		Widget* m_hoverTarget;
+		std::vector<float> m_eventTimes;	//when each queued event was received, if tracking latency
+		WidgetHandle m_focus;				//holds the currently focused widget if any
+		WidgetHandle m_hoverTarget;
 		sf::RenderWindow& m_window;			//pointer to the window we're working on
 		uint32 m_hotSpotX, m_hotSpotY;		//used for dragging			
 		bool m_drag;						//TODO: deprecated
 		bool m_editEnabled;
+		bool m_coalesceMouseMoves;			//keep only the latest of consecutive mouse moves
+		bool m_retainedMode;				//replay the drawing of unchanged top-level widgets
+		bool m_partialRedraw;				//only draw the damaged parts of the window
+		DamageRegion m_damage;				//reported since the last update
+		DamageRegion m_lastDamage;			//reported during the previous frame
+		DamageRegion m_drawnDamage;			//drawn by the last update
+		sf::Color m_clearColor;
+		Rect m_viewRect;					//the view drawn last, widgets outside it are culled
+		bool m_occlusionCulling;			//skip the widgets behind opaque top-level widgets
+		OcclusionBuffer m_occlusion;		//the opaque top-level widgets, front to back
+		std::vector<uint32> m_inFront;		//per top-level widget back to front, occluders in front of it
+		uint32 m_occluderCount;				//occluders in front of the widget being drawn
+		CullStats m_cullStats;				//of the frame being drawn
+		CullStats m_lastCullStats;			//of the last frame
 		std::vector<AbstractFactory*> m_factories;
 		GuiMgrParser m_parser;
 		mutable Mediator m_mediator;
 		Drag* m_curDrag;
+		InputRecorder* m_recorder;			//the input trace being recorded, if any
+
+		bool m_trackLatency;
+		LatencyStats m_latency;
+		sf::Clock m_clock;					//the time base of the event timestamps
+		mutable DrawList m_drawList;		//the widgets' draw commands of the current frame
+		SfmlBackend m_windowBackend;		//draws to m_window
+		RenderBackend* m_backend;			//the backend in use
+		float m_routedTime;					//timestamp of the event being routed, < 0 if none
 
 		//used when resizing
 		uint32 m_oldWidth;
 		uint32 m_oldHeight;
 
-		void SetHasFocus(WidgetList::reverse_iterator& i);
 		void StartDrag(Widget* widget, sf::Event* event);	//deprecated?
 		void MoveDrag(sf::Event* event);
 		void StopDrag(int x, int y);				
@@ -99,6 +220,19 @@ namespace gui {
 		void ClearWidgets();
 		void FreeWidgets();
 		void _HandleEvents();
+		void DrawWidget(Widget* widget);
+		void DrawDamage();
+		void UpdateViewRect();
+		void CullOccluded();
+		bool IsOccluded(const Rect& rect);
+		Rect ToScissor(const Rect& rect) const;
+
+		//keeps the name index in sync when a top-level widget gets renamed.
+		//A name already used by another one stays indexed to that one
+		void UpdateNameIndex(Widget* widget, uint32 oldName);
+
+		//drops the widget's entry, another one with the same name takes it over
+		void UnindexName(Widget* widget, uint32 nameSymbol);
 
 
 	};
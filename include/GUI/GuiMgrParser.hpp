@@ -6,6 +6,7 @@
 #include "Defines.hpp"
 #include <tinyxml.h>
 #include "Settings.hpp"
+#include "WidgetPath.hpp"
 
 namespace gui
 {
@@ -32,8 +33,14 @@ namespace gui
 		std::stack<TagLocation> m_tagLoc;
 		TagLocation GetTagLocation() const;
 
-		typedef std::map<uint32, std::vector<std::string> > ListenerInfo;
-		typedef std::map<std::string, ListenerInfo > LInfo;
+		//a saved connection's path, "this." ones are relative to their widget
+		struct ListenerPath {
+			ListenerPath(const std::string& path, bool allowRelative);
+			WidgetPath m_path;
+			bool m_relative;
+		};
+		typedef std::map<uint32, std::vector<ListenerPath> > ListenerInfo;
+		typedef std::map<uint32, ListenerInfo > LInfo;		//by listener symbol
 		
 		struct WidgetInfo {
 			WidgetInfo(Widget* widget = NULL, uint32 type = WIDGET);
@@ -51,7 +58,7 @@ namespace gui
 		void CompileWidget(WidgetInfo& info);
 		void CompileGui();
 
-		std::string currentListener;
+		uint32 currentListener;		//symbol of the <listener> being parsed
 		bool m_loadLayout;
 	};
 }
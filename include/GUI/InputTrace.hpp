@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Defines.hpp"
+#include <fstream>
+
+namespace gui
+{
+	class GuiManager;
+
+	/* Writes the events registered in a GuiManager and the Update(diff)
+	 * deltas to a compact binary trace(.sgtr), so a session can be played
+	 * back later by an InputReplayer. The events registered before an
+	 * Update belong to that frame, the frame timestamps are the running
+	 * sum of the deltas. Attach it with GuiManager::SetRecorder().
+	 */
+	class InputRecorder
+	{
+	public:
+		InputRecorder();
+		~InputRecorder();
+
+		//truncates the file, returns false if it can't be opened
+		bool Start(const std::string& filename);
+		void Stop();
+		bool IsRecording() const;
+
+		void RecordEvent(const sf::Event& event);
+		void RecordFrame(float diff);
+
+		uint32 GetFrameCount() const;
+		uint32 GetEventCount() const;
+	private:
+		std::ofstream m_file;
+		std::vector<uint8> m_buffer;	//records waiting to be written
+		uint32 m_frames;				//frames recorded since Start()
+		uint32 m_events;				//events recorded since Start()
+		uint32 m_frameEnd;				//size of the buffered records up to the last frame
+
+		void Flush();
+
+		//non-copyable, it owns the file
+		InputRecorder(const InputRecorder&);
+		InputRecorder& operator=(const InputRecorder&);
+	};
+
+	/* Feeds a trace written by an InputRecorder back through 
+	 * GuiManager::RegisterEvent/Update, frame by frame, with the recorded
+	 * deltas. Nothing is read from the window, so the replay doesn't 
+	 * depend on the user or the real time and runs the same every time.
+	 */
+	class InputReplayer
+	{
+	public:
+		InputReplayer();
+
+		//loads the whole trace, returns false if it's missing or invalid
+		bool Load(const std::string& filename);
+
+		//registers the events of the next frame and updates the gui with
+		//its delta, returns false once all the frames were played
+		bool Step(GuiManager& gui);
+
+		//plays all the remaining frames
+		void Run(GuiManager& gui);
+
+		//starts from the first frame again
+		void Rewind();
+		bool IsDone() const;
+
+		uint32 GetFrameCount() const;
+		uint32 GetCurrentFrame() const;
+
+		//the recorded delta/timestamp of a frame, in the units passed to Update
+		float GetFrameDiff(uint32 frame) const;
+		float GetFrameTime(uint32 frame) const;
+	private:
+		struct Frame {
+			float diff;				//the delta passed to Update
+			float time;				//the sum of the deltas before this frame
+			uint32 firstEvent;		//index in m_events
+			uint32 eventCount;
+		};
+
+		std::vector<Frame> m_frames;
+		std::vector<sf::Event> m_events;
+		uint32 m_current;				//the next frame to play
+	};
+}
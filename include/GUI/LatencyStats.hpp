@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Defines.hpp"
+#include <ostream>
+
+namespace gui
+{
+	/* Per event type latency histograms, from the moment the gui manager
+	 * received an input event until it got handled. Two stages are kept:
+	 * Dispatch, when a widget handler(OnClickPressed, OnKeyPressed..) runs,
+	 * and Consume, when a mediator listener reads the event it caused.
+	 * The buckets are powers of two in microseconds, so the percentiles 
+	 * are upper bounds within a factor of two.
+	 */
+	class LatencyStats
+	{
+	public:
+		enum Stage {
+			Dispatch,
+			Consume,
+			StageCount
+		};
+
+		LatencyStats();
+
+		void Record(Stage stage, uint32 eventType, float seconds);
+		void Reset();
+
+		//the user defined event types share a single histogram
+		uint32 GetCount(Stage stage, uint32 eventType) const;
+		float GetMean(Stage stage, uint32 eventType) const;
+		float GetMax(Stage stage, uint32 eventType) const;
+
+		//percentile in [0,1], in seconds
+		float GetPercentile(Stage stage, uint32 eventType, float percentile) const;
+
+		//writes a line per stage/type that has samples
+		void Dump(std::ostream& os) const;
+		void Dump() const;	//to the debug log
+
+		//dumps to the debug log every interval, in the units passed to
+		//GuiManager::Update. 0 disables the periodic dump(the default)
+		void SetDumpInterval(float interval);
+		float GetDumpInterval() const;
+		void Update(float diff);
+	private:
+		enum { 
+			BucketCount = 24,				//bucket i holds [2^(i-1),2^i) us, about 8s at most
+			TypeCount = events::Count + 1	//the last one holds the user defined types
+		};
+
+		struct Histogram {
+			uint32 buckets[BucketCount];
+			uint32 count;
+			double sum;					//in seconds
+			float max;
+		};
+
+		Histogram m_histograms[StageCount][TypeCount];
+		float m_dumpInterval;
+		float m_sinceDump;				//time since the last periodic dump
+
+		static uint32 TypeIndex(uint32 eventType);
+		static uint32 BucketIndex(float seconds);
+		const Histogram& Get(Stage stage, uint32 eventType) const;
+	};
+}
@@ -19,6 +19,7 @@ namespace gui {
 		void Draw() const;
 		void _SetCursorPos();
 		uint32 _FindCursorPos(const std::string& text, uint32 pos,int searchType);
+		Rect GetCursorRect() const;
 	protected:
 		void ReloadSettings();
 		void InitGraphics();
@@ -3,7 +3,8 @@
 #include "Defines.hpp"
 #include <map>
 #include "Event.hpp"
-#include <queue>
+#include "WidgetPath.hpp"
+#include "SymbolTable.hpp"
 
 class TiXmlNode;
 
@@ -12,33 +13,103 @@ namespace gui
 
 	class Widget;
 
+	/* Queue of pending events, stored in a fixed size ring buffer that's 
+	 * allocated on the first push. What happens when it's full depends on 
+	 * the overflow policy.
+	 */
 	struct Listener {
 	public:
-		Listener();
+		enum OverflowPolicy {
+			DropOldest,		//the oldest pending event makes room for the new one
+			DropNewest,		//the new event is discarded
+			Coalesce,		//the new event replaces the newest pending one of the same type
+			Grow			//the buffer doubles its capacity
+		};
+
+		struct Stats {
+			Stats();
+			uint32 highWaterMark;	//the most events pending at once
+			uint32 drops;			//events lost because the buffer was full
+			uint32 coalesces;		//events replaced by newer ones of the same type
+		};
+
+		Listener(uint32 capacity = 64, OverflowPolicy policy = DropOldest);
 		void push(Event*);
 		Event* pop();
+
+		//releases all the pending events
 		void clear();
 
+		uint32 size() const;
+		bool empty() const;
+
+		//can't go below the number of pending events
+		void SetCapacity(uint32 capacity);
+		uint32 GetCapacity() const;
+
+		void SetOverflowPolicy(OverflowPolicy policy);
+		OverflowPolicy GetOverflowPolicy() const;
+
+		//if set, events get merged into pending events of the same type
+		//and source(see Event::Coalesce), so only one is read per frame
+		void SetCoalescing(bool flag);
+		bool IsCoalescing() const;
+
+		const Stats& GetStats() const;
+		void ResetStats();
 	private:
-		uint32 m_maxCount;
-		std::queue<Event*> m_events;
+		friend class Mediator;
+		std::vector<Event*> m_buffer;	//the ring buffer, empty until the first push
+		uint32 m_capacity;				//the size of the buffer once allocated
+		uint32 m_head;					//index of the oldest pending event
+		uint32 m_count;					//number of pending events
+		OverflowPolicy m_policy;		//what push does when the buffer is full
+		bool m_coalesce;				//merge events from the same source while pending
+		Stats m_stats;
+		Widget* m_owner;				//gets marked for update when events arrive
+
+		bool Replace(Event* e);
+		bool Merge(Event* e);
+		void Reallocate(uint32 capacity);
 	};
 
-	typedef std::map<std::string, Listener > ListnerList;
+	//the listeners by name symbol(see SymbolTable), a mediator rarely has more than a few
+	typedef std::vector<std::pair<uint32, Listener*> > ListnerList;
 	typedef std::pair<std::string,uint32> ListenerEventPair;
 
+	/* Sends events to the listeners registered for their type. The listeners
+	 * of the sf::Event and gui::events types are kept in a table indexed by
+	 * the type, other(user defined) types fall back to a map.
+	 */
 	class Dispatcher
 	{
 	public:
-		Dispatcher() {}
-		bool CaresAbout(uint32 eventType);
+		Dispatcher();
+
+		//a bit test for the known event types, cheap enough to call before creating events
+		bool CaresAbout(uint32 eventType) const {
+			if(m_anyCount) return true;
+			if(eventType < events::Count) return (m_mask & (1u << eventType)) != 0;
+			return CaresAboutOther(eventType);
+		}
+
 		void RegisterListener(uint32 eventType, Listener* listener);
 		void RegisterListener(Listener* listener);
 		bool UnRegisterListner(uint32 eventType, Listener* listener);
 		void DispatchEvent(Event* event);
 		void ClearListeners();
 	private:
-		std::map<uint32, std::vector<Listener*> > m_listeners;
+		typedef std::vector<Listener*> ListenerVector;
+
+		ListenerVector m_listeners[events::Count];			//the listeners of each known event type
+		ListenerVector m_anyListeners;						//listeners of all the events
+		std::map<uint32, ListenerVector> m_otherListeners;	//listeners of user defined event types
+		uint32 m_mask;										//bit set for each known type having listeners
+		uint32 m_anyCount;									//the number of listeners of all the events
+
+		ListenerVector* GetListeners(uint32 eventType, bool create);
+		bool CaresAboutOther(uint32 eventType) const;
+		void UpdateMask(uint32 eventType);
 	};
 
 	class Mediator;
@@ -60,16 +131,68 @@ namespace gui
 		~Mediator();
 		Dispatcher& GetDispatcher() const;
 
+		//the returned event is valid until the next call
 		Event* GetEvent() const;
+
+		//takes over the event, it gets freed if nobody listens to it
 		void PostEvent(Event* event);
 		void ConsumeEvents();
 
+		//emits the direct signal of the event, then creates and posts the 
+		//event only if someone listens to its type
+		//usage: PostEvent<gui::OnMove>(widget, oldRect);
+		template<typename T>
+		void PostEvent(Widget* widget) {
+			EmitSignal<T>(widget,NoArgument());
+			if(m_dispatcher.CaresAbout(T::EventType)) PostEvent(new T(widget));
+		}
+		template<typename T, typename A1>
+		void PostEvent(Widget* widget, const A1& arg1) {
+			EmitSignal<T>(widget,arg1);
+			if(m_dispatcher.CaresAbout(T::EventType)) PostEvent(new T(widget,arg1));
+		}
+
+		//the synchronous signal of the widget event T, created on first use
+		template<typename T>
+		Signal<T>& GetSignal() {
+			SignalBase* signal = FindSignal(T::EventType);
+			if(!signal) {
+				signal = new Signal<T>();
+				AddSignal(T::EventType,signal);
+			}
+			return *static_cast<Signal<T>*>(signal);
+		}
+
+		//calls the slots of the signal right away, if it has any
+		template<typename T>
+		void EmitSignal(Widget* widget, const typename T::Argument& arg) {
+			if(m_signals.empty()) return;
+			SignalBase* signal = FindSignal(T::EventType);
+			if(signal) static_cast<Signal<T>*>(signal)->Emit(widget,arg);
+		}
+
+		//frees all the signals and their slots
+		void ClearSignals();
+
+		//whether posting the event type would reach anyone, check it
+		//before creating the event
+		bool HasListeners(uint32 eventType) const;
+
 		bool SetDefaultListener() const;
 		bool SwitchListener(const std::string& listener = "default") const;
+		bool SwitchListener(uint32 listener) const;
 
+		//creates the listener if it doesn't exist yet
 		Listener* GetListener(const std::string& listener = "default") const;
+		Listener* GetListener(uint32 listener) const;
 		Listener* GetCurrentListener() const;
 
+		//NULL if the mediator has no such listener
+		Listener* FindListener(uint32 listener) const;
+
+		//opt-in per listener, see Listener::SetCoalescing
+		void SetCoalescing(bool flag, const std::string& listener = "default");
+
 		//whether it has connections..(listeners ..active)
 		bool IsActive() const;
 
@@ -77,6 +200,8 @@ namespace gui
 		//to the specific eventType
 		bool Connect(Widget* with, const std::string& my_listener, 
 					 uint32 eventType, bool saveConnection = true);
+		bool Connect(Widget* with, uint32 my_listener, 
+					 uint32 eventType, bool saveConnection = true);
 
 		//connects the current mediator to the widget found by executing
 		//the query. The widget must be registered in the gui mgr to work!
@@ -89,10 +214,18 @@ namespace gui
 					const std::string& my_listener, uint32 eventType,
 					bool saveConnection = true);
 
+		//same as above, but with a precompiled path that can be reused
+		bool Connect(const WidgetPath& path, const std::string& my_listener,
+					 uint32 eventType, bool saveConnection = true);
+		bool Connect(Widget* current, const WidgetPath& path,
+					 const std::string& my_listener, uint32 eventType,
+					 bool saveConnection = true);
+
 		//disconnects the current mediator to the widget passed as parameter
 		//to the specific eventType
 		bool Disconnect(Widget* with, const std::string& my_listener, 
 						uint32 eventType);
+		bool Disconnect(Widget* with, uint32 my_listener, uint32 eventType);
 
 		//disconnects the current mediator to the widget found by executing
 		//the query. The widget must be registered in the gui mgr to work!
@@ -104,23 +237,48 @@ namespace gui
 		bool Disconnect(Widget* current, const std::string& path, 
 			const std::string& my_listener, uint32 eventType);
 
+		//same as above, but with a precompiled path that can be reused
+		bool Disconnect(const WidgetPath& path, const std::string& my_listener,
+						uint32 eventType);
+		bool Disconnect(Widget* current, const WidgetPath& path,
+						const std::string& my_listener, uint32 eventType);
+
 		void SaveConnections(TiXmlNode* node) const;
 		void ClearConnections();
 		void SetCurrentPath(const std::string& path);
+
+		//the widget that gets updated when its listeners receive events
+		void SetOwner(Widget* owner);
 	private:
 
 		mutable Listener* m_currentListener;
 		mutable Dispatcher m_dispatcher;
 		mutable ListnerList m_listeners;
-		mutable Event* m_freeEvent;
+		mutable Event* m_freeEvent;				//the last event returned, released at the next GetEvent()
+		Widget* m_owner;						//the widget owning the mediator, if any
 
 		std::string m_currentPath;				//widget path
+		WidgetPath m_currentWidgetPath;			//compiled version of the widget path
 		static GuiManager* s_currentGui;		//current gui
 
 		//used to keep track of connection created (for saving ui)
 		
-		typedef std::map<std::string, std::vector<ConnectionInfo*> > ConnectionList;
+		typedef std::map<uint32, std::vector<ConnectionInfo*> > ConnectionList;
 		ConnectionList m_connections;
 
+		//the direct signals, by event type. Few widgets have more than one or two
+		typedef std::vector<std::pair<uint32, SignalBase*> > SignalList;
+		SignalList m_signals;
+
+		SignalBase* FindSignal(uint32 eventType) const;
+		void AddSignal(uint32 eventType, SignalBase* signal);
+
+		//resolves a path relative to the current widget path
+		Widget* QueryRelative(const std::string& path) const;
+		Widget* QueryRelative(const WidgetPath& path) const;
+
+		//non-copyable, it owns its listeners and signals
+		Mediator(const Mediator&);
+		Mediator& operator=(const Mediator&);
 	};
 }
\ No newline at end of file
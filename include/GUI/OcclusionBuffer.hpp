@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	/* The opaque rects of the top-level widgets, added front to back(in
+	 * view coordinates). A rect is occluded if the occluders in front of 
+	 * it cover it entirely, together not just one by one. Occluders past
+	 * the maximum are ignored, which only means less gets culled.
+	 */
+	class OcclusionBuffer
+	{
+	public:
+		OcclusionBuffer(uint32 maxOccluders = 16);
+
+		//empty rects are ignored
+		void Add(const Rect& rect);
+		void Clear();
+
+		uint32 GetCount() const;
+		const std::vector<Rect>& GetRects() const;
+
+		//whether the first count occluders cover the rect, empty rects 
+		//aren't occluded
+		bool IsOccluded(const Rect& rect, uint32 count) const;
+		bool IsOccluded(const Rect& rect) const;
+	private:
+		std::vector<Rect> m_rects;
+		uint32 m_maxOccluders;
+
+		//the uncovered parts of the rect being tested, kept to avoid allocations
+		mutable std::vector<Rect> m_parts;
+		mutable std::vector<Rect> m_nextParts;
+	};
+}
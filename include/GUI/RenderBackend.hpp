@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	/* A colored vertex, in view coordinates */
+	struct ColorVertex {
+		float x, y;
+		sf::Color color;
+	};
+
+	/* Where the gui's drawing ends up. Everything the widgets draw goes
+	 * through the DrawList, which submits it to the backend of the gui:
+	 * the render window by default(SfmlBackend), or a software framebuffer
+	 * for machines without a GPU(SoftwareBackend).
+	 */
+	class RenderBackend
+	{
+	public:
+		virtual ~RenderBackend();
+
+		//the size of the target in pixels
+		virtual uint32 GetWidth() const = 0;
+		virtual uint32 GetHeight() const = 0;
+
+		//in pixels with the origin at the bottom-left(like glScissor),
+		//NULL disables the clipping
+		virtual void SetScissor(const Rect* scissor) = 0;
+
+		//4 vertices per quad, colors are interpolated across the quad
+		virtual void DrawQuads(const ColorVertex* vertices, uint32 count) = 0;
+
+		virtual void Draw(const sf::Drawable& drawable) = 0;
+	};
+
+	/* Draws to an SFML render window through OpenGL */
+	class SfmlBackend : public RenderBackend
+	{
+	public:
+		SfmlBackend(sf::RenderWindow& window);
+
+		sf::RenderWindow& GetWindow() const;
+
+		virtual uint32 GetWidth() const;
+		virtual uint32 GetHeight() const;
+		virtual void SetScissor(const Rect* scissor);
+		virtual void DrawQuads(const ColorVertex* vertices, uint32 count);
+		virtual void Draw(const sf::Drawable& drawable);
+	private:
+		/* Draws a range of vertices as quads in one go */
+		class QuadBatch : public sf::Drawable
+		{
+		public:
+			QuadBatch(const ColorVertex* vertices, uint32 count);
+		protected:
+			virtual void Render(sf::RenderTarget& target) const;
+		private:
+			const ColorVertex* m_vertices;
+			uint32 m_count;
+		};
+
+		sf::RenderWindow* m_window;
+		bool m_scissor;				//whether the scissor test is enabled
+	};
+}
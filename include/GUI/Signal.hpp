@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	class Widget;
+
+	//the argument of the events carrying only the widget
+	struct NoArgument {};
+
+	/* Type erased base, so a mediator can own signals of different types */
+	class SignalBase
+	{
+	public:
+		virtual ~SignalBase();
+	};
+
+	/* Direct, synchronous alternative to the queued Mediator connections.
+	 * The slots are called right away when the widget posts the event T,
+	 * without creating an Event object, allocating or waiting for the next
+	 * Update. T is one of the widget events(OnValueChanged, OnMove..), the
+	 * slots receive the sender and the event's argument(T::Argument).
+	 * usage:
+	 *   void OnSlider(gui::Widget* sender, const gui::int32& value, void* data);
+	 *   slider->Signal<gui::OnValueChanged>().Connect(&OnSlider);
+	 *   slider->Signal<gui::OnValueChanged>().Connect<MyWindow,&MyWindow::OnSlider>(this);
+	 * Slots can connect/disconnect while the signal is emitted, but must
+	 * not free the sender(killing it is fine).
+	 */
+	template<typename T>
+	class Signal : public SignalBase
+	{
+	public:
+		typedef typename T::Argument Argument;
+		typedef void (*Function)(Widget* sender, const Argument& arg, void* userData);
+
+		Signal() : m_nextId(1), m_emitting(0), m_dirty(false) {}
+
+		//returns an id that can be used to disconnect the slot
+		uint32 Connect(Function function, void* userData = NULL) {
+			Slot slot;
+			slot.call = &CallFunction;
+			slot.function = function;
+			slot.object = userData;
+			slot.id = m_nextId++;
+			m_slots.push_back(slot);
+			return slot.id;
+		}
+
+		//calls the member function on the object, no binding is allocated
+		template<typename C, void (C::*Method)(Widget*, const typename T::Argument&)>
+		uint32 Connect(C* object) {
+			Slot slot;
+			slot.call = &CallMethod<C,Method>;
+			slot.function = NULL;
+			slot.object = object;
+			slot.id = m_nextId++;
+			m_slots.push_back(slot);
+			return slot.id;
+		}
+
+		bool Disconnect(uint32 id) {
+			for(uint32 i=0; i<m_slots.size(); i++) {
+				if(m_slots[i].id != id) continue;
+				Remove(i);
+				return true;
+			}
+			return false;
+		}
+
+		//disconnects all the slots bound to the object/user data
+		void DisconnectAll(const void* object) {
+			for(uint32 i=m_slots.size(); i>0; i--) {
+				if(m_slots[i-1].object == object) Remove(i-1);
+			}
+		}
+
+		void Clear() {
+			for(uint32 i=m_slots.size(); i>0; i--) {
+				Remove(i-1);
+			}
+		}
+
+		bool IsEmpty() const { return m_slots.empty(); }
+
+		void Emit(Widget* sender, const Argument& arg) {
+			//slots connected during the emission are called next time
+			uint32 count = m_slots.size();
+			m_emitting++;
+			for(uint32 i=0; i<count; i++) {
+				const Slot& slot = m_slots[i];
+				if(slot.call) slot.call(slot,sender,arg);
+			}
+			m_emitting--;
+			if(!m_emitting && m_dirty) Compact();
+		}
+	private:
+		struct Slot;
+		typedef void (*Call)(const Slot& slot, Widget* sender, const Argument& arg);
+
+		struct Slot {
+			Call call;				//NULL once disconnected during an emission
+			Function function;		//the free function, if any
+			void* object;			//the object or the user data
+			uint32 id;
+		};
+
+		std::vector<Slot> m_slots;
+		uint32 m_nextId;			//id of the next connected slot
+		uint32 m_emitting;			//depth of nested Emit() calls
+		bool m_dirty;				//slots were disconnected while emitting
+
+		static void CallFunction(const Slot& slot, Widget* sender, const Argument& arg) {
+			slot.function(sender,arg,slot.object);
+		}
+
+		template<typename C, void (C::*Method)(Widget*, const typename T::Argument&)>
+		static void CallMethod(const Slot& slot, Widget* sender, const Argument& arg) {
+			(static_cast<C*>(slot.object)->*Method)(sender,arg);
+		}
+
+		void Remove(uint32 index) {
+			//the emitting loop indexes the vector, so only mark it
+			if(m_emitting) {
+				m_slots[index].call = NULL;
+				m_slots[index].object = NULL;
+				m_slots[index].id = 0;
+				m_dirty = true;
+				return;
+			}
+			m_slots.erase(m_slots.begin() + index);
+		}
+
+		void Compact() {
+			uint32 j = 0;
+			for(uint32 i=0; i<m_slots.size(); i++) {
+				if(m_slots[i].call) m_slots[j++] = m_slots[i];
+			}
+			m_slots.resize(j);
+			m_dirty = false;
+		}
+	};
+}
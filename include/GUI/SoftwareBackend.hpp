@@ -0,0 +1,75 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+
+namespace gui
+{
+	class TextMesh;
+
+	/* CPU rasterizer drawing into an RGBA framebuffer in memory, so the gui
+	 * can be drawn, timed and have its pixels checked without a GPU. It
+	 * handles what the widgets draw: colored quads(gradients included),
+	 * sf::Shape, sf::Sprite, sf::String and TextMesh, with alpha blending
+	 * and scissor clipping. Other drawables are skipped. Shape outlines are
+	 * centered on the edges and flipped sprites aren't flipped.
+	 */
+	class SoftwareBackend : public RenderBackend
+	{
+	public:
+		SoftwareBackend(uint32 width, uint32 height);
+
+		//resizing clears the framebuffer
+		void Resize(uint32 width, uint32 height);
+		void Clear(const sf::Color& color = sf::Color(0,0,0));
+
+		//the part of the view the framebuffer shows, the framebuffer's
+		//size at the origin by default
+		void SetView(const sf::FloatRect& view);
+		const sf::FloatRect& GetView() const;
+
+		sf::Color GetPixel(uint32 x, uint32 y) const;
+
+		//RGBA, rows from top to bottom
+		const uint8* GetPixels() const;
+
+		//hash of all the pixels, to compare whole frames
+		uint32 GetChecksum() const;
+
+		virtual uint32 GetWidth() const;
+		virtual uint32 GetHeight() const;
+		virtual void SetScissor(const Rect* scissor);
+		virtual void DrawQuads(const ColorVertex* vertices, uint32 count);
+		virtual void Draw(const sf::Drawable& drawable);
+	private:
+		struct Vertex {
+			float x, y;			//in pixels
+			float u, v;			//in texels, for textured triangles
+			sf::Color color;
+		};
+
+		/* Maps an image's texture coordinates to its pixels */
+		struct Texture {
+			Texture(const sf::Image& image);
+			const sf::Image& image;
+			float scaleX, scaleY;		//texture coords -> texels
+			sf::Color Sample(float x, float y) const;
+		};
+
+		std::vector<uint8> m_pixels;
+		uint32 m_width, m_height;
+		sf::FloatRect m_view;
+		bool m_clipping;
+		int32 m_clipLeft, m_clipTop, m_clipRight, m_clipBottom;	//in framebuffer rows, exclusive
+
+		Vertex ToPixels(const sf::Vector2f& point, const sf::Color& color) const;
+
+		void DrawShape(const sf::Shape& shape);
+		void DrawSprite(const sf::Sprite& sprite);
+		void DrawMesh(const TextMesh& mesh);
+		void DrawQuad(const Vertex* quad, const Texture* texture);
+
+		//sharedEdge skips the pixels on the a-b edge, drawn by the previous triangle
+		void FillTriangle(const Vertex& a, const Vertex& b, const Vertex& c, const Texture* texture, bool sharedEdge);
+		void Blend(uint32 x, uint32 y, const sf::Color& color);
+	};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	class Widget;
+
+	/* Uniform grid over the rects of a container's child widgets, used to
+	 * find the widgets under a point without walking the whole list.
+	 * The rects are relative to the container, so moving it doesn't
+	 * re-bucket anything. Results are returned front to back(highest 
+	 * focus level first).
+	 */
+	class SpatialIndex
+	{
+	public:
+		SpatialIndex(uint32 cellSize = 64);
+
+		void Insert(Widget* widget);
+		void Remove(Widget* widget);
+
+		//re-buckets the widget if its rect changed, does nothing if it's not indexed
+		void Update(Widget* widget);
+		void Clear();
+
+		//appends the widgets whose rect contains the point/intersects the rect
+		void QueryPoint(int x, int y, std::vector<Widget*>& result) const;
+		void QueryRect(const Rect& rect, std::vector<Widget*>& result) const;
+
+		uint32 GetSize() const;
+	private:
+		struct Entry {
+			Rect rect;					//the rect at the time it was indexed
+			int32 x0, y0, x1, y1;		//the covered cells, inclusive
+			bool large;					//too many cells, kept in m_large instead
+		};
+
+		typedef std::tr1::unordered_map<Widget*, Entry> EntryList;
+		typedef std::tr1::unordered_map<uint32, std::vector<Widget*> > CellList;
+
+		uint32 m_cellSize;				//the width/height of a cell in pixels
+		EntryList m_entries;			//all the indexed widgets
+		CellList m_cells;				//the widgets overlapping each cell
+		std::vector<Widget*> m_large;	//widgets spanning too many cells, always tested
+
+		static uint32 CellKey(int32 cx, int32 cy);
+		int32 CellCoord(int32 v) const;
+		void Link(Widget* widget, Entry& entry);
+		void Unlink(Widget* widget, const Entry& entry);
+		static void SortByFocus(std::vector<Widget*>& result, uint32 from);
+	};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	/* Global table of interned strings. Listener names and widget names 
+	 * are turned into small integer ids once(when loading or renaming), 
+	 * so the hot lookups compare integers instead of strings. Symbols are
+	 * never freed, the same string always maps to the same id.
+	 */
+	class SymbolTable
+	{
+	public:
+		enum {
+			Default = 0,			//"default", the default listener
+			Empty = 1,				//"", unnamed widgets
+			Invalid = 0xFFFFFFFF	//returned by Find() for unknown strings
+		};
+
+		//returns the id of the string, adding it if needed
+		static uint32 Intern(const std::string& name);
+
+		//returns Invalid if the string was never interned
+		static uint32 Find(const std::string& name);
+
+		static const std::string& GetName(uint32 symbol);
+		static uint32 GetSize();
+	private:
+		typedef std::tr1::unordered_map<std::string, uint32> SymbolIndex;
+
+		struct Table {
+			Table();
+			SymbolIndex index;					//string -> id
+			std::vector<std::string> names;		//id -> string
+		};
+
+		//created on first use, widgets can be constructed during static init
+		static Table& GetTable();
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Widget.hpp"
+#include "GlyphAtlas.hpp"
 #include <vector>
 
 namespace gui 
@@ -22,11 +23,13 @@ namespace gui
 		float GetWidth() const;
 		std::string GetText() const;
 
+		//lays the line out in the container, line_spacing below its top
 		void SetPos(const Rect& container,uint32 line_spacing);
 		uint32 GetLineSpacing() const;
 
 		std::vector<Word> m_words;
 		LineAlignment m_align;	
+		TextMesh m_mesh;	//the glyphs of the line relative to the text, rebuilt by SetPos
 	};
 
 //***********************************************************************
@@ -73,13 +76,37 @@ namespace gui
 		const std::string& GetText() const;
 		void Resize(int w, int h, bool save = true);
 		void SetPos(int x, int y, bool forceMove = false, bool save=true);
+
+		//scrolls the text so the offset(in pixels from the top of the text)
+		//is at the top of the area, clamped to the text. Smooth scrolling 
+		//gets there over a few frames
+		void ScrollTo(float offset, bool smooth = true);
+		void ScrollBy(float delta, bool smooth = true);
+		void ScrollToLine(uint32 line, bool smooth = true);
+		float GetScroll() const;
+
+		//the height of the whole text in pixels
+		uint32 GetTextHeight() const;
+
+		//the lines drawn, at least partly inside the area
+		uint32 GetFirstVisibleLine() const;
+		uint32 GetVisibleLineCount() const;
 	private:
 		std::string m_text;
 		std::vector<Line> m_lines;
+		std::vector<uint32> m_lineTops;	//the top of every line in the text, then the text's height
 		uint32 m_viewableLines;
 		uint32 m_totalLines;
 		uint32 m_startingLine;
+		float m_scroll;					//the text's offset at the top of the area
+		float m_targetScroll;			//where smooth scrolling is heading
+		TextMesh m_mesh;	//the visible lines merged, drawn in one go
 		
+		void Layout();
+		void UpdateVisibleLines();
+		void RebuildMesh();
+		virtual void Update(float diff);
+		virtual void OnOtherEvents(sf::Event* event);
 		virtual void Draw() const;
 		virtual void InitGraphics();
 		virtual void ReloadSettings();
@@ -6,6 +6,10 @@
 #include "Theme.hpp"
 #include "Mediator.hpp"
 #include "Drag.hpp"
+#include "SpatialIndex.hpp"
+#include "WidgetList.hpp"
+#include "WidgetHandle.hpp"
+#include "DrawList.hpp"
 
 class TiXmlNode;
 
@@ -16,7 +20,7 @@ namespace gui {
 	public:
 		friend class GuiManager;
 		friend class GuiMgrParser;
-		typedef std::map<uint32, Widget*> WidgetList;	
+		friend class WidgetList;
 
 		enum SizePolicy {
 			Default,
@@ -55,8 +59,10 @@ namespace gui {
 		void SetSolid(bool flag);
 
 		Widget* FindChildByName(const std::string& name) const;
+		Widget* FindChildBySymbol(uint32 nameSymbol) const;
 		std::string GetWidgetPath() const;
 		Widget* QueryWidget(const std::string& path) const;
+		Widget* QueryWidget(const WidgetPath& path) const;
 		std::vector<Widget*> GetWidgetStackPath() const;
 		WidgetList& GetWidgetList() const;
 		Widget* GetWidgetAt(const sf::Vector2f& pos) const;
@@ -71,6 +77,11 @@ namespace gui {
 		void SetBackgroundColor(sf::Color color);
 		Mediator& GetMediator() const;
 
+		//the direct signal of a widget event, see gui::Signal
+		//usage: widget->Signal<gui::OnValueChanged>().Connect(&OnValue);
+		template<typename T>
+		gui::Signal<T>& Signal() { return m_mediator.GetSignal<T>(); }
+
 		virtual void Resize(int w, int h,bool save = true);
 		virtual void SetPos(int x, int y, bool forceMove = false, bool save = true);
 		virtual void SetPos(const sf::Vector2f& pos, bool forceMove = false, bool save = true);
@@ -79,18 +90,38 @@ namespace gui {
 		uint8 GetTransparency() const;
 		void SetTransparency(uint8 val);
 
+		//the rect in world coordinates, brought up to date if a parent moved
 		const Rect& GetRect() const;
 		sf::Vector2f GetPos() const;
 		sf::Vector2f GetSize() const;
 
+		//the rect relative to the parent(the same as GetRect() without a parent)
+		Rect GetLocalRect() const;
+		const sf::Vector2i& GetLocalPos() const;
+
 		void SetName(const std::string& newName);
 		const std::string& GetName() const;
+		uint32 GetNameSymbol() const;
 
 		uint32 GetId() const;
 		void SetId(uint32 id);
 
+		//weak reference that becomes NULL once the widget is killed or freed
+		const WidgetHandle& GetHandle() const;
+
+		//higher values are in front of their siblings
+		uint32 GetZOrder() const;
+
+		//queues the event until the next update, the gui routes its events
+		//right away instead(see RouteEvent)
 		void RegisterEvent(sf::Event* event);
 
+		//delivers the event now. The path to the target is found once(the
+		//hit children for mouse presses and moves, the focused ones for the
+		//rest), then every parent on it gets OnCaptureEvent before its 
+		//child, then OnChildEvent after it(bubbling back up)
+		void RouteEvent(sf::Event* event);
+
 		/* Attributes Modifiers */
 		void SetMovable(bool flag);
 		bool IsMovable() const;
@@ -129,8 +160,22 @@ namespace gui {
 		void SetVerticalPolicy(SizePolicy policy);
 		void SetHorizontalPolicy(SizePolicy policy);
 
+		//marks the widget and its parents to be visited by the next update,
+		//clean subtrees are skipped
+		void MarkDirty();
+		bool NeedsUpdate() const;
+
+		//reports the widget's rect(or a part of the screen) as changed, 
+		//only matters when the gui does partial redraws
+		void Repaint();
+		void Repaint(const Rect& rect);
+
 		virtual void Draw() const;
 
+		//the part of the widget its parents and the view left visible, as of
+		//the last draw. Empty if the widget was culled
+		const Rect& GetVisibleRect() const;
+
 		void FreeDeadWidgets();
 
 		virtual bool IsCollision(const Rect& rect) const;
@@ -139,22 +184,34 @@ namespace gui {
 		/* Attributes */
 		uint32 m_type;						//the type of the widget		
 		mutable WidgetList m_widgets;		//holds the child widgets
+		NameIndex m_nameIndex;				//the child widgets, indexed by name
+		NameCount m_shadowedNames;			//the names more than one child uses
+		SpatialIndex m_spatialIndex;		//the child widgets, indexed by position
 		Widget* m_parent;					//the parent widget if any
-		Widget* m_focus;					//the child widget in focus if any
-		Widget* m_hoverTarget;				//the current child widget that has hover
-		std::vector<sf::Event*> m_events;	//event queue
+		WidgetHandle m_focus;				//the child widget in focus if any
+		WidgetHandle m_hoverTarget;			//the current child widget that has hover
+		std::vector<sf::Event*> m_events;	//events registered from outside the routing
 		sf::Shape m_shape;					//the background image
 		sf::Sprite* m_sprite;				//used to draw images.. only use it when needed else let it NULL
-		uint32 m_id;						//used by parents to find them in the widget list
-		uint32 index;						//internally used to keep track of focusing levels
+		uint32 m_id;						//unique id, doesn't change during the widget's lifetime
+		WidgetHandle m_handle;				//the slot given to this widget while it's alive
+		WidgetListNode m_zNode;				//links to the siblings, ordered by focus level
 		std::string m_name;					//name of the widget
-		bool m_needUpdate;					//currently unused?
+		uint32 m_nameSymbol;				//the interned name
+		bool m_needUpdate;					//dirty flag, if set all the parents have it set too
 		bool m_loading;						//true if the widget is currently being loaded from an .ui file
 		bool m_isFocus;						//whether the widget has focus either globally or in another widget
 		bool m_clicked;						//was the widget clicked ?
 		bool m_released;					//was the click released ?
-		Rect m_rect;						//the position/size of the widget
+		Rect m_rect;						//the position/size of the widget, cached world coordinates
+		sf::Vector2i m_localPos;			//the position relative to the parent
+		uint32 m_worldStamp;				//changes every time the world position changes
+		mutable uint32 m_parentStamp;		//the parent's world stamp m_rect was computed from
+		mutable uint32 m_validStamp;		//the transform stamp m_rect was last validated at
+		bool m_applyingTransform;			//set while following a parent's move
+		bool m_resolvingCollisions;			//set while pushing the child widgets apart
 		Rect m_clipRect;					//the visible portion of the widget
+		mutable Rect m_visibleRect;			//m_rect clipped by the parents and the view, set when drawn
 		bool m_visible;						//widget visibility
 		bool m_mainVisible;					//background image visibility
 		bool m_movable;						//is the widget movable ?
@@ -169,6 +226,7 @@ namespace gui {
 		Drag::DropFlags m_dropFlags;		//specifies the drop policy(where the widget may be dropped)
 		bool m_dead;						//if widget committed suicided it will be removed at the next updated
 		std::vector<Widget*> m_freeWidgets;	//widgets that will be deleted at each updated, if any
+		mutable DrawList::Cache m_drawCache;//the subtree's last drawing, top-level widgets in retained mode
 		
 		//Double Click attributes.. maybe move these to their own object?
 		float m_doubleClickDiff;			//diff timer for double click
@@ -184,6 +242,9 @@ namespace gui {
 		
 		/* Static member data */
 		static GuiManager* s_gui;			//pointer to the current gui
+		static uint32 s_nextId;				//the id given to the next widget created
+		static uint32 s_transformStamp;		//changes every time any widget gets moved
+		static std::vector<Widget*> s_eventPath;	//reused by RouteEvent, so it rarely allocates
 		static void ConvertCoords(sf::Vector2f& coords);
 
 		/* Widget specific events */
@@ -208,6 +269,10 @@ namespace gui {
 		virtual void OnTextEntered(sf::Event* event);
 
 		//child handling functions -- overload these
+		//capture phase: return true to keep the event from reaching the child
+		virtual bool OnCaptureEvent(Widget* child, sf::Event* event);
+
+		//bubble phase: the child(or one of its children) handled the event
 		virtual void OnChildEvent(Widget* child, sf::Event* event);
 
 		virtual void OnChildClickPressed(Widget* child,sf::Event* event);
@@ -218,8 +283,20 @@ namespace gui {
 		virtual void OnChildOtherEvents(Widget* child, sf::Event* event);
 
 		void _HandleEvents();
+
+		//the widgets the event goes through, from this one to the target
+		void GetEventPath(sf::Event* event, const sf::Vector2f& pos, std::vector<Widget*>& path);
+
+		//the live, visible child under pos(in view coordinates), if any.
+		//candidates is only scratch space, so it can be reused per level
+		Widget* GetHitChild(const sf::Vector2f& pos, std::vector<Widget*>& candidates) const;
+
+		//a parent's part of the routing, before and after its child on 
+		//the path got the event, and the target's own
+		void RouteDown(Widget* child, sf::Event* event);
+		void RouteUp(Widget* child, sf::Event* event, const sf::Vector2f& pos);
+		void RouteToTarget(sf::Event* event);
 		virtual void Update(float diff);
-		void Draw(const sf::Image* image);
 		void SetFocus(Widget* widget);
 		virtual void ReloadTheme();
 		virtual void ReloadSettings();
@@ -227,6 +304,18 @@ namespace gui {
 		virtual void UpdateClipArea();
 
 		//handle clipping
+		void DrawChildren() const;
+
+		//sets m_visibleRect to the part of the widget inside clip, returns
+		//false if nothing is left and the subtree doesn't need drawing
+		bool UpdateVisibleRect(const Rect& clip) const;
+
+		//the rect the children get clipped to, in view coordinates
+		virtual Rect GetChildClipRect() const;
+
+		//the part of the widget its background covers opaquely, nothing 
+		//behind it shows there. Empty if the background isn't opaque
+		virtual Rect GetOpaqueRect() const;
 		void StartClipping() const;
 		void StopClipping() const;
 		void ResizeClipArea(uint32 newWidth, uint32 newHeight);
@@ -244,6 +333,21 @@ namespace gui {
 		virtual bool SetPosFromDrag(Drag* drag);	//will be called to set the position from dragging
 
 		bool ContainsWidget(Widget* widget);
+
+		//keeps the name index in sync when a child gets renamed. A name
+		//already used by a sibling stays indexed to that sibling
+		void UpdateNameIndex(Widget* child, uint32 oldName);
+
+		//drops the child's entry, a sibling with the same name takes it over
+		void UnindexName(Widget* child, uint32 nameSymbol);
+
+		//re-buckets the widget in its parent's(or the gui's) spatial index
+		void UpdateSpatialIndex();
+
+		//recomputes m_rect from the parent's rect if any parent moved since
+		//the last call, must be done before reading another widget's m_rect
+		void ValidateTransform() const;
+		void ApplyTransform();
 	private:
  		bool m_drag;					//deprecated
  		int m_hotSpotX, m_hotSpotY;		//deprecated
@@ -254,9 +358,9 @@ namespace gui {
 		void _HandleOnFocusLost();
 		void SaveLayout(TiXmlNode* node) const;
 		void SaveUI(TiXmlNode* node) const;
-		void ResolveChildCollisions();
+		void SavePosition() const;
+		void ResolveChildCollisions(Widget* moved);
 		void SetLoading(bool val);
-		//Rect GetSmallestParentClipRect();
 	};
 
 
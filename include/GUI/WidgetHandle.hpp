@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	class Widget;
+
+	/* Weak reference to a widget: a slot in a global table plus the 
+	 * generation of the slot when the handle was taken. Once the widget 
+	 * gets freed the slot's generation changes, so every handle to it 
+	 * resolves to NULL in O(1) without scanning the tree. A killed widget
+	 * still resolves until it's freed, check IsDead() if that matters.
+	 */
+	class WidgetHandle
+	{
+	public:
+		WidgetHandle();
+		WidgetHandle(const Widget* widget);
+
+		//NULL if the widget was freed
+		Widget* Get() const;
+		bool IsValid() const;
+		void Reset();
+
+		operator Widget*() const { return Get(); }
+		Widget* operator->() const { return Get(); }
+
+		uint32 GetSlot() const;
+		uint32 GetGeneration() const;
+
+		//gives the widget a slot, the returned handle stays valid until Release()
+		static WidgetHandle Acquire(Widget* widget);
+
+		//invalidates every handle to the widget, the slot gets reused
+		static void Release(const WidgetHandle& handle);
+	private:
+		struct Slot {
+			Widget* widget;			//NULL if the slot is free
+			uint32 generation;		//bumped every time the slot is released
+		};
+
+		uint32 m_slot;				//index in the slot table
+		uint32 m_generation;		//0 is never a valid generation
+
+		static std::vector<Slot> s_slots;		//all the slots, used or not
+		static std::vector<uint32> s_freeSlots;	//released slots waiting to be reused
+	};
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	class Widget;
+	class WidgetList;
+
+	/* The links every widget carries to be part of a WidgetList */
+	struct WidgetListNode
+	{
+		WidgetListNode(Widget* widget = NULL);
+
+		Widget* self;				//the widget owning the node
+		WidgetListNode* prev;		//the widget behind, if any
+		WidgetListNode* next;		//the widget in front, if any
+		WidgetList* list;			//the list the widget is part of, if any
+		uint32 zOrder;				//higher values are closer to the front
+	};
+
+	/* Intrusive list of widgets ordered back to front: the last widget is
+	 * drawn last and receives the mouse events first. Adding, removing,
+	 * raising and lowering a widget are O(1) and never allocate.
+	 */
+	class WidgetList
+	{
+	public:
+		template<typename NodePtr, bool Forward>
+		class Iterator
+		{
+		public:
+			Iterator(NodePtr node = NULL) : m_node(node) {}
+
+			//allows iterator -> const_iterator conversions
+			template<typename OtherPtr>
+			Iterator(const Iterator<OtherPtr,Forward>& other) : m_node(other.GetNode()) {}
+
+			Widget* operator*() const { return m_node->self; }
+
+			Iterator& operator++() {
+				m_node = Forward ? m_node->next : m_node->prev;
+				return *this;
+			}
+			Iterator operator++(int) {
+				Iterator temp(*this);
+				++(*this);
+				return temp;
+			}
+			bool operator==(const Iterator& other) const { return m_node == other.m_node; }
+			bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+
+			NodePtr GetNode() const { return m_node; }
+		private:
+			NodePtr m_node;
+		};
+
+		typedef Iterator<WidgetListNode*, true> iterator;
+		typedef Iterator<const WidgetListNode*, true> const_iterator;
+		typedef Iterator<WidgetListNode*, false> reverse_iterator;
+		typedef Iterator<const WidgetListNode*, false> const_reverse_iterator;
+
+		WidgetList();
+		~WidgetList();
+
+		//back to front
+		iterator begin() { return iterator(m_bottom); }
+		iterator end() { return iterator(); }
+		const_iterator begin() const { return const_iterator(m_bottom); }
+		const_iterator end() const { return const_iterator(); }
+
+		//front to back
+		reverse_iterator rbegin() { return reverse_iterator(m_top); }
+		reverse_iterator rend() { return reverse_iterator(); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(m_top); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(); }
+
+		uint32 size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+
+		//the front-most/back-most widgets
+		Widget* top() const;
+		Widget* bottom() const;
+
+		//adds the widget behind/in front of all the others
+		void push_front(Widget* widget);
+		void push_back(Widget* widget);
+
+		//moves the widget in front of/behind all the others
+		void raise(Widget* widget);
+		void lower(Widget* widget);
+
+		//does nothing if the widget isn't part of this list
+		void remove(Widget* widget);
+
+		bool contains(const Widget* widget) const;
+
+		//unlinks all the widgets, doesn't free them
+		void clear();
+	private:
+		WidgetListNode* m_bottom;	//the first widget drawn
+		WidgetListNode* m_top;		//the last widget drawn
+		uint32 m_size;				//number of widgets in the list
+		uint32 m_topZ;				//z-order of the front-most widget
+		uint32 m_bottomZ;			//z-order of the back-most widget
+
+		void LinkTop(WidgetListNode* node);
+		void LinkBottom(WidgetListNode* node);
+		void Unlink(WidgetListNode* node);
+		void Renumber();
+
+		//non-copyable, the widgets can only be part of one list
+		WidgetList(const WidgetList&);
+		WidgetList& operator=(const WidgetList&);
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Defines.hpp"
+
+namespace gui
+{
+	class Widget;
+	class GuiManager;
+
+	/* A widget path ("window.titlebar.close") split into its segments once,
+	 * so it can be resolved many times without extra string work. The 
+	 * segments are interned(see SymbolTable), resolving only looks up 
+	 * integers. The last resolved widget is cached until the widget tree 
+	 * changes structure.
+	 */
+	class WidgetPath
+	{
+	public:
+		WidgetPath();
+		explicit WidgetPath(const std::string& path);
+		explicit WidgetPath(const char* path);
+
+		//splits the path into segments, drops the cached widget
+		void Compile(const std::string& path);
+
+		//resolves the path starting from the gui's top-level widgets
+		Widget* Resolve(const GuiManager* gui) const;
+
+		//resolves the path starting from the children of root
+		Widget* Resolve(const Widget* root) const;
+
+		//the first segment that isn't found(the whole path if all are), 
+		//for the error messages after a failed resolve. It isn't cached
+		const std::string& GetMissingSegment(const GuiManager* gui) const;
+		const std::string& GetMissingSegment(const Widget* root) const;
+
+		const std::string& GetPath() const;
+		const std::string& GetSegment(uint32 index) const;
+		uint32 GetSegmentCount() const;
+		bool IsEmpty() const;
+
+		//must be called whenever widgets are added, removed, renamed or freed
+		static void Invalidate();
+		static uint32 GetStamp();
+	private:
+		std::string m_path;						//the original path
+		std::vector<std::string> m_segments;	//the path split by '.'
+		std::vector<uint32> m_symbols;			//the interned segments
+
+		mutable Widget* m_cached;				//the last resolved widget
+		mutable const void* m_cachedRoot;		//where the last resolve started from
+		mutable uint32 m_cachedStamp;			//the tree stamp at the time of the last resolve
+
+		static uint32 s_stamp;					//bumped on every structural change
+
+		Widget* ResolveFrom(Widget* first) const;
+		const std::string& FindMissingFrom(Widget* first) const;
+		bool IsCached(const void* root) const;
+		Widget* Cache(const void* root, Widget* result) const;
+	};
+}
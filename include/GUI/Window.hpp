@@ -26,8 +26,12 @@ namespace gui
 		virtual bool SetPosFromDrag(Drag* drag);
 		virtual bool HandleDragStop(Drag* drag);
 		virtual void UpdateClipArea();
+		virtual Rect GetChildClipRect() const;
+		virtual Rect GetOpaqueRect() const;
 		virtual void ReloadSettings();
 		void SetButtonStyle(TitleBar::ButtonStyle button_style);
 	private:
+		//the height left showing while minimized
+		int GetTitleBarHeight() const;
 	};
 }
\ No newline at end of file
@@ -31,7 +31,7 @@ namespace gui
 	{
 		if(!m_visible) return;
 		Widget::Draw();
-		s_gui->GetWindow().Draw(m_text);
+		s_gui->GetDrawList().Add(m_text);
 	}
 
 	void Button::OnClickPressed(sf::Event* event)
@@ -87,6 +87,8 @@ namespace gui
 	void Button::SetText( const std::string& text )
 	{
 		m_text.SetText(text);
+		MarkDirty();
+		Repaint();
 	}
 
 	void Button::InitGraphics()
@@ -127,8 +129,8 @@ namespace gui
 	{
 		if(!m_sprite || !m_visible) return;
 
-		s_gui->GetWindow().Draw(*m_sprite);
-		s_gui->GetWindow().Draw(m_text);
+		s_gui->GetDrawList().Add(*m_sprite);
+		s_gui->GetDrawList().Add(m_text);
 
 		//buttons should really have children in the first place :|
 // 		for(WidgetList::iterator it = m_widgets.begin(); 
@@ -0,0 +1,105 @@
+#include "../include/gui/DamageRegion.hpp"
+#include <algorithm>
+
+namespace gui
+{
+	DamageRegion::DamageRegion( uint32 maxRects /*= 8*/ ) :
+		m_maxRects(maxRects ? maxRects : 1)
+	{
+
+	}
+
+	void DamageRegion::Add( const Rect& rect )
+	{
+		if(rect.w <= 0 || rect.h <= 0) return;
+		m_rects.push_back(rect);
+	}
+
+	void DamageRegion::Add( const DamageRegion& region )
+	{
+		m_rects.insert(m_rects.end(),region.m_rects.begin(),region.m_rects.end());
+	}
+
+	void DamageRegion::Merge()
+	{
+		//keep joining pairs until nothing changes, the lists are tiny
+		bool merged = true;
+		while(merged) {
+			merged = false;
+			for(uint32 i=0; i<m_rects.size(); i++) {
+				for(uint32 j=i+1; j<m_rects.size(); j++) {
+					if(!ShouldMerge(m_rects[i],m_rects[j])) continue;
+
+					m_rects[i] = GetUnion(m_rects[i],m_rects[j]);
+					m_rects[j] = m_rects.back();
+					m_rects.pop_back();
+					merged = true;
+					--j;
+				}
+			}
+		}
+
+		if(m_rects.size() > m_maxRects) {
+			Rect bounds = GetBounds();
+			m_rects.clear();
+			m_rects.push_back(bounds);
+		}
+	}
+
+	void DamageRegion::Clear()
+	{
+		m_rects.clear();
+	}
+
+	bool DamageRegion::IsEmpty() const
+	{
+		return m_rects.empty();
+	}
+
+	bool DamageRegion::Intersects( const Rect& rect ) const
+	{
+		for(uint32 i=0; i<m_rects.size(); i++) {
+			if(IsCollision(m_rects[i],rect)) return true;
+		}
+		return false;
+	}
+
+	const std::vector<Rect>& DamageRegion::GetRects() const
+	{
+		return m_rects;
+	}
+
+	gui::Rect DamageRegion::GetBounds() const
+	{
+		if(m_rects.empty()) return Rect();
+
+		Rect bounds = m_rects[0];
+		for(uint32 i=1; i<m_rects.size(); i++) {
+			bounds = GetUnion(bounds,m_rects[i]);
+		}
+		return bounds;
+	}
+
+	gui::uint32 DamageRegion::GetArea() const
+	{
+		uint32 area = 0;
+		for(uint32 i=0; i<m_rects.size(); i++) {
+			area += Area(m_rects[i]);
+		}
+		return area;
+	}
+
+	gui::uint32 DamageRegion::Area( const Rect& rect )
+	{
+		return uint32(rect.w) * uint32(rect.h);
+	}
+
+	bool DamageRegion::ShouldMerge( const Rect& first, const Rect& second )
+	{
+		if(IsCollision(first,second)) return true;
+
+		//the union wastes less than the smaller rect, one draw instead of two
+		uint32 a = Area(first), b = Area(second);
+		return Area(GetUnion(first,second)) <= a + b + std::min(a,b);
+	}
+}
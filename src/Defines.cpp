@@ -2,6 +2,7 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 namespace gui {
 
@@ -14,6 +15,27 @@ namespace gui {
 			);	
 	}
 
+	Rect GetIntersection( const Rect& first, const Rect& second )
+	{
+		int32 left = std::max(first.x,second.x);
+		int32 top = std::max(first.y,second.y);
+		int32 right = std::min(first.x+first.w,second.x+second.w);
+		int32 bottom = std::min(first.y+first.h,second.y+second.h);
+
+		if(right <= left || bottom <= top) return Rect();
+		return Rect(left,top,right-left,bottom-top);
+	}
+
+	Rect GetUnion( const Rect& first, const Rect& second )
+	{
+		int32 left = std::min(first.x,second.x);
+		int32 top = std::min(first.y,second.y);
+		int32 right = std::max(first.x+first.w,second.x+second.w);
+		int32 bottom = std::max(first.y+first.h,second.y+second.h);
+
+		return Rect(left,top,right-left,bottom-top);
+	}
+
 	bool IsCollision( const Rect& a1, const Rect& b1, sf::Vector2f& normal )
 	{
 // 	   Since the vector is a pointer then it could have been
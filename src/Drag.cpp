@@ -122,6 +122,12 @@ namespace gui
 			m_status = Finished;
 		else return false;
 
+		//the target died during the drag
+		if(!m_target || m_target->IsDead()) {
+			m_dropStatus = Failed;
+			return false;
+		}
+
 		//if the widget isn't movable and you don't force it to move.. 
 		//then the drag failed!
 		if(!m_target->IsMovable() && !m_forceMove) {
@@ -179,7 +185,7 @@ namespace gui
 
 	void Drag::ResetPosition()
 	{
-		assert(m_target);
+		if(!m_target) return;
 
 		m_target->SetPos(m_startPos,true);
 	}
@@ -0,0 +1,310 @@
+#include "../include/gui/DrawList.hpp"
+#include "../include/gui/Debug.hpp"
+
+namespace gui
+{
+	DrawList::Stats::Stats() : commands(0), quads(0), drawCalls(0), clipChanges(0),
+		cachedCommands(0)
+	{
+
+	}
+
+	DrawList::Cache::Cache() : m_valid(false)
+	{
+
+	}
+
+	bool DrawList::Cache::IsValid() const
+	{
+		return m_valid;
+	}
+
+	void DrawList::Cache::Invalidate()
+	{
+		//the buffers are kept, the next recording reuses them
+		m_valid = false;
+	}
+
+	gui::uint32 DrawList::Cache::GetCommandCount() const
+	{
+		return m_valid ? m_commands.size() : 0;
+	}
+
+	DrawList::DrawList() : m_backend(NULL), m_recording(false), m_batching(true),
+		m_mergeFrom(0), m_cacheCommand(0), m_cacheVertex(0), m_cacheClip(0),
+		m_cacheDepth(0), m_cache(NULL)
+	{
+
+	}
+
+	void DrawList::Begin( RenderBackend* backend )
+	{
+		if(m_recording) {
+			debug_log("The previous frame wasn't flushed!");
+			Flush();
+		}
+		m_backend = backend;
+		m_recording = m_batching && backend;
+		m_stats = Stats();
+	}
+
+	void DrawList::Flush()
+	{
+		if(!m_recording) return;
+		m_recording = false;
+
+		int32 applied = -1;
+		for(uint32 i=0; i<m_commands.size(); i++) {
+			const Command& c = m_commands[i];
+			ApplyClip(c.clip,applied);
+
+			if(c.type == QuadCommand) {
+				m_backend->DrawQuads(&m_vertices[c.first],c.count);
+			} else {
+				m_backend->Draw(*c.drawable);
+			}
+			m_stats.drawCalls++;
+		}
+		ApplyClip(-1,applied);
+
+		if(m_cache) {
+			debug_log("A draw cache was still being recorded!");
+			m_cache = NULL;
+		}
+
+		m_lastStats = m_stats;
+		m_commands.clear();
+		m_vertices.clear();
+		m_clips.clear();
+		m_clipStack.clear();
+		m_mergeFrom = 0;
+	}
+
+	bool DrawList::IsRecording() const
+	{
+		return m_recording;
+	}
+
+	void DrawList::SetBatching( bool flag )
+	{
+		if(!flag) Flush();
+		m_batching = flag;
+	}
+
+	bool DrawList::IsBatching() const
+	{
+		return m_batching;
+	}
+
+	void DrawList::AddQuad( float x, float y, float w, float h, const sf::Color& color )
+	{
+		if(!m_recording) {
+			if(m_backend) m_backend->Draw(sf::Shape::Rectangle(x,y,x+w,y+h,color));
+			return;
+		}
+		AddCommand(QuadCommand);
+		AddVertex(x,y,color);
+		AddVertex(x+w,y,color);
+		AddVertex(x+w,y+h,color);
+		AddVertex(x,y+h,color);
+	}
+
+	void DrawList::Add( const sf::Shape& shape )
+	{
+		//only what sf::Shape would draw as a plain quad
+		if(!m_recording || shape.GetNbPoints() != 4 || shape.GetOutlineWidth() != 0.f ||
+			shape.GetRotation() != 0.f || shape.GetScale() != sf::Vector2f(1.f,1.f) ||
+			shape.GetBlendMode() != sf::Blend::Alpha) 
+		{
+			Add((const sf::Drawable&)shape);
+			return;
+		}
+
+		sf::Vector2f offset = shape.GetPosition() - shape.GetCenter();
+		AddCommand(QuadCommand);
+		for(uint32 i=0; i<4; i++) {
+			const sf::Vector2f& p = shape.GetPointPosition(i);
+			AddVertex(offset.x+p.x,offset.y+p.y,shape.GetPointColor(i)*shape.GetColor());
+		}
+	}
+
+	void DrawList::Add( const sf::Drawable& drawable )
+	{
+		if(!m_recording) {
+			if(m_backend) m_backend->Draw(drawable);
+			return;
+		}
+		AddCommand(DrawableCommand).drawable = &drawable;
+	}
+
+	void DrawList::PushClip( const Rect& scissor )
+	{
+		//nested clips only ever shrink the visible area
+		int32 current = GetCurrentClip();
+		Rect rect = current < 0 ? scissor : GetIntersection(scissor,m_clips[current]);
+
+		m_clips.push_back(rect);
+		m_clipStack.push_back(m_clips.size()-1);
+
+		if(!m_recording && m_backend) {
+			m_backend->SetScissor(&m_clips.back());
+		}
+	}
+
+	void DrawList::PopClip()
+	{
+		if(m_clipStack.empty()) return;
+		m_clipStack.pop_back();
+
+		if(!m_recording) {
+			int32 clip = GetCurrentClip();
+			if(m_backend) m_backend->SetScissor(clip < 0 ? NULL : &m_clips[clip]);
+			if(clip < 0) m_clips.clear();
+		}
+	}
+
+	void DrawList::BeginCache( Cache& cache )
+	{
+		cache.Invalidate();
+
+		//nothing gets recorded, so there's nothing to keep
+		if(!m_recording || !m_clipStack.empty()) return;
+		if(m_cache) {
+			debug_log("Draw caches can't be nested!");
+			return;
+		}
+		m_cache = &cache;
+		m_cacheCommand = m_commands.size();
+		m_cacheVertex = m_vertices.size();
+		m_cacheClip = m_clips.size();
+		m_cacheDepth = m_clipStack.size();
+
+		//the first quads of the cache can't join the previous batch
+		m_mergeFrom = m_commands.size();
+	}
+
+	void DrawList::EndCache( Cache& cache )
+	{
+		if(m_cache != &cache) return;
+		m_cache = NULL;
+
+		//same for the quads after it, they'd be missing from the replay
+		m_mergeFrom = m_commands.size();
+
+		if(m_clipStack.size() != m_cacheDepth) {
+			debug_log("Unbalanced clipping while recording a draw cache!");
+			return;
+		}
+		for(uint32 i=m_cacheCommand; i<m_commands.size(); i++) {
+			//clipped by a rect pushed before the cache started
+			if(m_commands[i].clip >= 0 && m_commands[i].clip < (int32)m_cacheClip) return;
+		}
+
+		cache.m_commands.assign(m_commands.begin()+m_cacheCommand,m_commands.end());
+		cache.m_vertices.assign(m_vertices.begin()+m_cacheVertex,m_vertices.end());
+		cache.m_clips.assign(m_clips.begin()+m_cacheClip,m_clips.end());
+
+		for(uint32 i=0; i<cache.m_commands.size(); i++) {
+			Command& c = cache.m_commands[i];
+			c.first -= m_cacheVertex;
+			if(c.clip >= 0) c.clip -= m_cacheClip;
+		}
+		cache.m_valid = true;
+	}
+
+	void DrawList::AddCache( const Cache& cache )
+	{
+		if(!cache.IsValid()) return;
+		if(!m_recording) {
+			debug_log("Draw caches can only be replayed while recording!");
+			return;
+		}
+
+		uint32 vertexBase = m_vertices.size();
+		int32 clipBase = m_clips.size();
+		int32 outer = GetCurrentClip();
+
+		m_vertices.insert(m_vertices.end(),cache.m_vertices.begin(),cache.m_vertices.end());
+		m_clips.insert(m_clips.end(),cache.m_clips.begin(),cache.m_clips.end());
+
+		//the cached clips are limited by the one they are replayed in
+		if(outer >= 0) {
+			for(uint32 i=clipBase; i<m_clips.size(); i++) {
+				m_clips[i] = GetIntersection(m_clips[i],m_clips[outer]);
+			}
+		}
+
+		for(uint32 i=0; i<cache.m_commands.size(); i++) {
+			Command c = cache.m_commands[i];
+			c.first += vertexBase;
+
+			//unclipped commands take the clip they are replayed in
+			c.clip = c.clip < 0 ? outer : c.clip + clipBase;
+			m_commands.push_back(c);
+
+			if(c.type == QuadCommand) m_stats.quads += c.count / 4;
+		}
+		m_stats.commands += cache.m_commands.size();
+		m_stats.cachedCommands += cache.m_commands.size();
+		m_mergeFrom = m_commands.size();
+	}
+
+	const DrawList::Stats& DrawList::GetStats() const
+	{
+		return m_lastStats;
+	}
+
+	gui::int32 DrawList::GetCurrentClip() const
+	{
+		return m_clipStack.empty() ? -1 : m_clipStack.back();
+	}
+
+	void DrawList::ApplyClip( int32 clip, int32& applied )
+	{
+		if(clip == applied) return;
+
+		//different pushes of the same rect don't need a state change
+		if(clip >= 0 && applied >= 0 && m_clips[clip] == m_clips[applied]) {
+			applied = clip;
+			return;
+		}
+		m_backend->SetScissor(clip < 0 ? NULL : &m_clips[clip]);
+		applied = clip;
+		m_stats.clipChanges++;
+	}
+
+	void DrawList::AddVertex( float x, float y, const sf::Color& color )
+	{
+		Vertex v;
+		v.x = x;
+		v.y = y;
+		v.color = color;
+		m_vertices.push_back(v);
+		m_commands.back().count++;
+	}
+
+	DrawList::Command& DrawList::AddCommand( CommandType type )
+	{
+		int32 clip = GetCurrentClip();
+		if(type == QuadCommand) m_stats.quads++;
+
+		//quads following quads with the same clip join their batch
+		if(type == QuadCommand && m_commands.size() > m_mergeFrom) {
+			Command& last = m_commands.back();
+			if(last.type == QuadCommand && (last.clip == clip || (last.clip >= 0 && clip >= 0 && 
+				m_clips[last.clip] == m_clips[clip]))) 
+			{
+				return last;
+			}
+		}
+		Command c;
+		c.type = type;
+		c.first = m_vertices.size();
+		c.count = 0;
+		c.drawable = NULL;
+		c.clip = clip;
+		m_commands.push_back(c);
+		m_stats.commands++;
+		return m_commands.back();
+	}
+}
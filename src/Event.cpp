@@ -1,8 +1,74 @@
 #include "../include/gui/Event.hpp"
 #include "../include/gui/Defines.hpp"
+#include "../include/gui/Debug.hpp"
 
 namespace gui 
 {
+	//events are pooled by size, rounded up to the granularity
+	static const size_t POOL_GRANULARITY = 8;
+	static const size_t POOL_MAX_SIZE = 256;		//bigger events use the heap directly
+	static const uint32 POOL_CHUNK_COUNT = 64;		//events allocated at once for a size
+
+	struct PoolNode {
+		PoolNode* next;
+	};
+
+	//one free list per size class, the chunks are never given back
+	static PoolNode* s_eventPools[POOL_MAX_SIZE/POOL_GRANULARITY];
+
+	static size_t PoolIndex(size_t size)
+	{
+		return (size + POOL_GRANULARITY - 1) / POOL_GRANULARITY - 1;
+	}
+
+	void* Event::operator new( size_t size )
+	{
+		if(size == 0 || size > POOL_MAX_SIZE) return ::operator new(size);
+
+		PoolNode*& head = s_eventPools[PoolIndex(size)];
+		if(!head) {
+			//the pool is empty, split a new chunk in free blocks
+			size_t block = (PoolIndex(size) + 1) * POOL_GRANULARITY;
+			char* chunk = (char*)::operator new(block * POOL_CHUNK_COUNT);
+			for(uint32 i=0; i<POOL_CHUNK_COUNT; i++) {
+				PoolNode* node = (PoolNode*)(chunk + i*block);
+				node->next = head;
+				head = node;
+			}
+		}
+		PoolNode* node = head;
+		head = node->next;
+		return node;
+	}
+
+	void Event::operator delete( void* memory, size_t size )
+	{
+		if(!memory) return;
+		if(size == 0 || size > POOL_MAX_SIZE) {
+			::operator delete(memory);
+			return;
+		}
+		PoolNode* node = (PoolNode*)memory;
+		PoolNode*& head = s_eventPools[PoolIndex(size)];
+		node->next = head;
+		head = node;
+	}
+
+	void Event::AddRef()
+	{
+		m_refCount++;
+	}
+
+	void Event::Release()
+	{
+		if(m_refCount == 0) {
+			error_log("Tried to release an event(%u) without references!", m_type);
+			return;
+		}
+		if(--m_refCount == 0) {
+			delete this;
+		}
+	}
 
 	SfmlEvent::SfmlEvent( sf::Event* event ) : m_event(event)
 	{
@@ -19,6 +85,15 @@ namespace gui
 		return m_widget;
 	}
 
+	bool WidgetEvent::IsSameSource( const Event* newer ) const
+	{
+		if(!newer || newer->GetType() != m_type) return false;
+
+		//the same type means the same event class
+		Widget* widget = GetWidget();
+		return widget && widget == static_cast<const WidgetEvent*>(newer)->GetWidget();
+	}
+
 	OnClickPressed::OnClickPressed( Widget* widget ) : WidgetEvent(widget)
 	{
 		m_type = sf::Event::MouseButtonPressed;
@@ -95,6 +170,11 @@ namespace gui
 		return m_oldRect;
 	}
 
+	bool OnResize::Coalesce( const Event* newer )
+	{
+		return IsSameSource(newer);
+	}
+
 	OnMove::OnMove( Widget* widget,const Rect& oldRect ) : 
 			WidgetEvent(widget)
 	{
@@ -107,7 +187,12 @@ namespace gui
 		return m_oldRect;
 	}
 
-	Event::Event() : m_refCount(0),m_type(WIDGET)
+	bool OnMove::Coalesce( const Event* newer )
+	{
+		return IsSameSource(newer);
+	}
+
+	Event::Event() : m_refCount(0),m_type(WIDGET),m_timestamp(-1.f)
 	{
 
 	}
@@ -122,6 +207,12 @@ namespace gui
 		return m_type;
 	}
 
+	bool Event::Coalesce( const Event* )
+	{
+		//nothing to merge in, only the derived events know their data
+		return false;
+	}
+
 
 	OnDrag::OnDrag( Widget* widget, Drag* drag ): 
 					WidgetEvent(widget)
@@ -135,6 +226,14 @@ namespace gui
 		return m_drag;
 	}
 
+	bool OnDrag::Coalesce( const Event* newer )
+	{
+		if(!IsSameSource(newer)) return false;
+
+		m_drag = static_cast<const OnDrag*>(newer)->m_drag;
+		return true;
+	}
+
 	OnValueChanged::OnValueChanged( Widget* widget, int32 value ) : 
 		WidgetEvent(widget), m_value(value)
 	{
@@ -146,6 +245,14 @@ namespace gui
 		return m_value;
 	}
 
+	bool OnValueChanged::Coalesce( const Event* newer )
+	{
+		if(!IsSameSource(newer)) return false;
+
+		m_value = static_cast<const OnValueChanged*>(newer)->m_value;
+		return true;
+	}
+
 
 	OnDoubleClick::OnDoubleClick( Widget* widget /*= NULL*/ ):
 			WidgetEvent(widget)
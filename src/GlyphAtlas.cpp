@@ -0,0 +1,322 @@
+#include "../include/gui/GlyphAtlas.hpp"
+#include "../include/gui/Debug.hpp"
+
+namespace gui
+{
+	//same values sf::String uses when rendering
+	static const float ITALIC_SHEAR = 0.208f;	//12 degrees
+	static const float BOLD_OFFSET = 0.5f;
+	static const float UNDERLINE_OFFSET = 2.f;
+
+	static const float BOLD_OFFSETS_X[] = {-1.f, 1.f, 0.f, 0.f};
+	static const float BOLD_OFFSETS_Y[] = {0.f, 0.f, -1.f, 1.f};
+
+	bool GlyphAtlas::Key::operator<( const Key& other ) const
+	{
+		if(font != other.font) return font < other.font;
+		if(size != other.size) return size < other.size;
+		return style < other.style;
+	}
+
+	GlyphAtlas::AtlasList& GlyphAtlas::GetAtlases()
+	{
+		static AtlasList atlases;
+		return atlases;
+	}
+
+	const GlyphAtlas& GlyphAtlas::Get( const sf::Font& font, float size, unsigned long style )
+	{
+		Key key;
+		key.font = &font;
+		key.size = size;
+		key.style = style;
+
+		AtlasList& atlases = GetAtlases();
+		AtlasList::iterator it = atlases.find(key);
+		if(it != atlases.end()) {
+			if(it->second->m_alive) return *it->second;
+
+			//built for a destroyed font that had the same address
+			delete it->second;
+			atlases.erase(it);
+		}
+
+		GlyphAtlas* atlas = new GlyphAtlas(font,size,style);
+		atlases[key] = atlas;
+		return *atlas;
+	}
+
+	void GlyphAtlas::Release( const sf::Font& font )
+	{
+		AtlasList& atlases = GetAtlases();
+		AtlasList::iterator it = atlases.begin();
+		while(it != atlases.end()) {
+			if(it->first.font == &font) {
+				delete it->second;
+				atlases.erase(it++);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	GlyphAtlas::GlyphAtlas( const sf::Font& font, float size, unsigned long style ) :
+		m_font(font), m_alive(&font), m_size(size), m_style(style), m_scale(1.f)
+	{
+		if(font.GetCharacterSize()) {
+			m_scale = size / (float)font.GetCharacterSize();
+		}
+		for(uint32 i=0; i<256; i++) {
+			BuildGlyph(i,m_glyphs[i]);
+		}
+	}
+
+	void GlyphAtlas::BuildGlyph( uint32 codepoint, Glyph& glyph ) const
+	{
+		const sf::Glyph& source = m_font.GetGlyph(codepoint);
+		const sf::IntRect& rect = source.Rectangle;
+		float shear = (m_style & sf::String::Italic) ? ITALIC_SHEAR : 0.f;
+
+		glyph.x[0] = (rect.Left - shear*rect.Top) * m_scale;
+		glyph.y[0] = rect.Top * m_scale;
+		glyph.x[1] = (rect.Left - shear*rect.Bottom) * m_scale;
+		glyph.y[1] = rect.Bottom * m_scale;
+		glyph.x[2] = (rect.Right - shear*rect.Bottom) * m_scale;
+		glyph.y[2] = rect.Bottom * m_scale;
+		glyph.x[3] = (rect.Right - shear*rect.Top) * m_scale;
+		glyph.y[3] = rect.Top * m_scale;
+		glyph.uv = source.TexCoords;
+
+		switch(codepoint) {
+			case ' ':
+				glyph.advance = source.Advance * m_scale;
+				glyph.visible = false;
+				break;
+			case '\t':
+				glyph.advance = source.Advance * 4 * m_scale;
+				glyph.visible = false;
+				break;
+			case '\n': case '\v':
+				//handled by the mesh, they move the pen down
+				glyph.advance = 0.f;
+				glyph.visible = false;
+				break;
+			default:
+				glyph.advance = (source.Advance + ((m_style & sf::String::Bold) ? 1 : 0)) * m_scale;
+				glyph.visible = (rect.Right > rect.Left && rect.Bottom > rect.Top);
+				break;
+		}
+	}
+
+	const GlyphAtlas::Glyph& GlyphAtlas::GetGlyph( uint32 codepoint ) const
+	{
+		if(codepoint < 256) return m_glyphs[codepoint];
+
+		//rare, only reachable through sf::String's own conversions
+		BuildGlyph(codepoint,m_other);
+		return m_other;
+	}
+
+	const sf::Image& GlyphAtlas::GetTexture() const
+	{
+		return m_font.GetImage();
+	}
+
+	const sf::Font& GlyphAtlas::GetFont() const
+	{
+		return m_font;
+	}
+
+	float GlyphAtlas::GetSize() const
+	{
+		return m_size;
+	}
+
+	unsigned long GlyphAtlas::GetStyle() const
+	{
+		return m_style;
+	}
+
+	float GlyphAtlas::GetLineHeight() const
+	{
+		return m_font.GetCharacterSize() * m_scale;
+	}
+
+	float GlyphAtlas::GetBoldOffset() const
+	{
+		return (m_style & sf::String::Bold) ? BOLD_OFFSET * m_scale : 0.f;
+	}
+
+	float GlyphAtlas::GetUnderlineOffset() const
+	{
+		return UNDERLINE_OFFSET * m_scale;
+	}
+
+	float GlyphAtlas::GetUnderlineThickness() const
+	{
+		return ((m_style & sf::String::Bold) ? 3.f : 2.f) * m_scale;
+	}
+
+	TextMesh::TextMesh()
+	{
+
+	}
+
+	TextMesh::Run& TextMesh::GetRun( const sf::Image* texture )
+	{
+		for(uint32 i=0; i<m_runs.size(); i++) {
+			if(m_runs[i].texture == texture) return m_runs[i];
+		}
+		m_runs.push_back(Run());
+		m_runs.back().texture = texture;
+		return m_runs.back();
+	}
+
+	void TextMesh::Append( const sf::String& string )
+	{
+		const sf::Unicode::UTF32String& text = string.GetText();
+		if(text.empty()) return;
+
+		const GlyphAtlas& atlas = GlyphAtlas::Get(string.GetFont(),string.GetSize(),string.GetStyle());
+		Run& run = GetRun(&atlas.GetTexture());
+
+		//only the position is used, the texts never get scaled or rotated
+		const sf::Vector2f& origin = string.GetPosition();
+		const sf::Color& color = string.GetColor();
+		bool underlined = (string.GetStyle() & sf::String::Underlined) != 0;
+		float bold = atlas.GetBoldOffset();
+		float lineHeight = atlas.GetLineHeight();
+
+		float x = 0.f, y = lineHeight;
+		std::vector<float> underlines;		//pairs of line width, line y
+
+		Vertex v;
+		v.color = color;
+		for(uint32 i=0; i<text.size(); i++) {
+			uint32 c = text[i];
+			if(c == '\n') {
+				if(underlined) {
+					underlines.push_back(x);
+					underlines.push_back(y);
+				}
+				y += lineHeight;
+				x = 0.f;
+				continue;
+			} else if(c == '\v') {
+				y += lineHeight * 4;
+				continue;
+			}
+
+			const GlyphAtlas::Glyph& glyph = atlas.GetGlyph(c);
+			if(glyph.visible) {
+				//the bold style adds 4 offset copies after the glyph itself
+				uint32 copies = bold > 0.f ? 5 : 1;
+				for(uint32 j=0; j<copies; j++) {
+					float ox = origin.x + x + (j ? BOLD_OFFSETS_X[j-1]*bold : 0.f);
+					float oy = origin.y + y + (j ? BOLD_OFFSETS_Y[j-1]*bold : 0.f);
+
+					for(uint32 k=0; k<4; k++) {
+						v.x = ox + glyph.x[k];
+						v.y = oy + glyph.y[k];
+						v.u = (k < 2) ? glyph.uv.Left : glyph.uv.Right;
+						v.v = (k == 0 || k == 3) ? glyph.uv.Top : glyph.uv.Bottom;
+						run.glyphs.push_back(v);
+					}
+				}
+			}
+			x += glyph.advance;
+		}
+		if(underlined) {
+			underlines.push_back(x);
+			underlines.push_back(y);
+		}
+
+		float offset = atlas.GetUnderlineOffset();
+		float thickness = atlas.GetUnderlineThickness();
+		v.u = v.v = 0.f;
+		for(uint32 i=0; i<underlines.size(); i+=2) {
+			float top = origin.y + underlines[i+1] + offset;
+			float right = origin.x + underlines[i];
+
+			v.x = origin.x; v.y = top;				run.lines.push_back(v);
+			v.x = origin.x; v.y = top + thickness;	run.lines.push_back(v);
+			v.x = right;	v.y = top + thickness;	run.lines.push_back(v);
+			v.x = right;	v.y = top;				run.lines.push_back(v);
+		}
+	}
+
+	void TextMesh::Append( const TextMesh& mesh, const sf::Vector2f& offset /*= sf::Vector2f(0.f,0.f)*/ )
+	{
+		for(uint32 i=0; i<mesh.m_runs.size(); i++) {
+			const Run& source = mesh.m_runs[i];
+			Run& run = GetRun(source.texture);
+			uint32 glyphs = run.glyphs.size(), lines = run.lines.size();
+			run.glyphs.insert(run.glyphs.end(),source.glyphs.begin(),source.glyphs.end());
+			run.lines.insert(run.lines.end(),source.lines.begin(),source.lines.end());
+
+			if(offset.x == 0.f && offset.y == 0.f) continue;
+			for(uint32 j=glyphs; j<run.glyphs.size(); j++) {
+				run.glyphs[j].x += offset.x;
+				run.glyphs[j].y += offset.y;
+			}
+			for(uint32 j=lines; j<run.lines.size(); j++) {
+				run.lines[j].x += offset.x;
+				run.lines[j].y += offset.y;
+			}
+		}
+	}
+
+	void TextMesh::Clear()
+	{
+		m_runs.clear();
+	}
+
+	bool TextMesh::IsEmpty() const
+	{
+		for(uint32 i=0; i<m_runs.size(); i++) {
+			if(m_runs[i].glyphs.size() || m_runs[i].lines.size()) return false;
+		}
+		return true;
+	}
+
+	gui::uint32 TextMesh::GetGlyphCount() const
+	{
+		uint32 count = 0;
+		for(uint32 i=0; i<m_runs.size(); i++) {
+			count += m_runs[i].glyphs.size() / 4;
+		}
+		return count;
+	}
+
+	void TextMesh::Render( sf::RenderTarget& ) const
+	{
+		for(uint32 i=0; i<m_runs.size(); i++) {
+			const Run& run = m_runs[i];
+
+			if(run.glyphs.size()) {
+				glEnable(GL_TEXTURE_2D);
+				run.texture->Bind();
+
+				glBegin(GL_QUADS);
+				for(uint32 j=0; j<run.glyphs.size(); j++) {
+					const Vertex& v = run.glyphs[j];
+					glColor4ub(v.color.r,v.color.g,v.color.b,v.color.a);
+					glTexCoord2f(v.u,v.v);
+					glVertex2f(v.x,v.y);
+				}
+				glEnd();
+			}
+			if(run.lines.size()) {
+				glDisable(GL_TEXTURE_2D);
+
+				glBegin(GL_QUADS);
+				for(uint32 j=0; j<run.lines.size(); j++) {
+					const Vertex& v = run.lines[j];
+					glColor4ub(v.color.r,v.color.g,v.color.b,v.color.a);
+					glVertex2f(v.x,v.y);
+				}
+				glEnd();
+			}
+		}
+	}
+}
@@ -476,7 +476,7 @@ namespace gui
 
 	}
 
-	void GridLayout::SetPosForGrid()
+	void GridLayout::SetPosForGrid(bool moveWidgets /* = true */)
 	{
 		uint32 xpos = m_rect.x;
 		uint32 ypos = m_rect.y;
@@ -501,7 +501,7 @@ namespace gui
 
 
 
-				layout_item.UpdateWidgetPos(m_panning);
+				if(moveWidgets) layout_item.UpdateWidgetPos(m_panning);
 			}
 			LayoutItem& layout_item = m_items[i][0];
 
@@ -757,7 +757,7 @@ namespace gui
 		for(uint32 i=0; i<m_items.size(); i++) {
 			for(uint32 j=0; j<m_items[i].size(); j++) {
 				StartClipping();
-					m_items[i][j].Draw(s_gui->GetWindow());
+					m_items[i][j].Draw(s_gui->GetDrawList());
 				StopClipping();
 			}
 		}
@@ -768,7 +768,8 @@ namespace gui
 	{
 		Widget::SetPos(x,y,forceMove,save);
 
-		SetPosForGrid();
+		//when following a parent the widgets keep their place in the cells
+		SetPosForGrid(!m_applyingTransform);
 	}
 
 	bool GridLayout::IsLineEmpty(uint32 line) const
@@ -1242,12 +1243,12 @@ namespace gui
 		m_colspan = colspan;
 	}
 
-	void LayoutItem::Draw( sf::RenderWindow& window ) const
+	void LayoutItem::Draw( DrawList& drawList ) const
 	{
  		if(m_expanded) 
  			return;
 
-		window.Draw(m_shape);
+		drawList.Add(m_shape);
 	}
 
 	void LayoutItem::UpdateWidgetPos( uint32 panning )
@@ -1289,7 +1290,7 @@ namespace gui
 			for(WidgetList::reverse_iterator it = m_widgets.rbegin();
 					it != m_widgets.rend(); it++) 
 			{
-				if(it->second->IsCollision(rect)) {
+				if((*it)->IsCollision(rect)) {
 					return true;
 				}
 			}
@@ -1313,6 +1314,8 @@ namespace gui
 		if(GetVerticalPolicy()	!= Widget::Fixed   ||
 		   GetHorizontalPolicy()!= Widget::Fixed)
 		{
+			//a single relayout per frame, no matter how often the parent resized
+			m_mediator.SetCoalescing(true);
 			m_mediator.Connect(parent,"default",events::OnResize,false);
 		}
 		ResizeFromParent();
@@ -2,18 +2,27 @@
 #include "../include/gui/Widget.hpp"
 #include "../include/gui/Debug.hpp"
 #include "../include/gui/DefaultFactory.hpp"
+#include "../include/gui/InputTrace.hpp"
 #include <tinyxml.h>
 #include <sstream>
+#include <cmath>
 
 #include <iostream>
 
 namespace gui {
 
-	GuiManager::GuiManager( sf::RenderWindow& window ):	m_window(window),
-				m_hotSpotX(0),m_hotSpotY(0), m_focus(NULL), 
-				m_drag(false),index(0),m_theme(NULL),m_hoverTarget(NULL),
-				m_curDrag(NULL),m_oldWidth(window.GetWidth()),
-				m_oldHeight(window.GetHeight()),m_editEnabled(false)
+	//m_inFront of a top-level widget hidden entirely by the ones in front
+	static const uint32 OCCLUDED = 0xFFFFFFFF;
+
+	GuiManager::GuiManager( sf::RenderWindow& window ):	m_theme(NULL),
+				m_focus(NULL),m_hoverTarget(NULL),m_window(window),
+				m_hotSpotX(0),m_hotSpotY(0),m_drag(false),m_editEnabled(false),
+				m_coalesceMouseMoves(false),m_retainedMode(false),m_partialRedraw(false),
+				m_clearColor(0,0,0),m_occlusionCulling(false),
+				m_occluderCount(0),m_curDrag(NULL),m_recorder(NULL),
+				m_trackLatency(false),m_windowBackend(window),m_backend(&m_windowBackend),
+				m_routedTime(-1.f),m_oldWidth(window.GetWidth()),
+				m_oldHeight(window.GetHeight())
 	{
 		m_parser.SetGui(this);
 		m_factories.push_back(new DefaultFactory());
@@ -33,7 +42,6 @@ namespace gui {
 
 	void GuiManager::DeleteWidget( const std::string& name )
 	{
-		//TODO: reduce the O(n) + O(log(n)) complexity
 		if(Widget* widget = GetWidgetByName(name)) {
 			m_freeWidgets.push_back(widget);
 		} else {
@@ -56,79 +64,128 @@ namespace gui {
 			error_log("Couldn't create widget named %s. Duplicate exists!",widget->GetName().c_str());
 			return false;
 		}
-		
-		widget->SetId(++index);
-		m_widgets[index] = widget;
 
+		//a widget can only be managed by one container at a time
+		if(Widget* parent = widget->GetParent()) {
+			parent->RemoveWidget(widget);
+			widget->SetParent(NULL);
+		}
+
+		m_widgets.push_back(widget);
+		m_nameIndex[widget->GetNameSymbol()] = widget;
+		m_spatialIndex.Insert(widget);
+		WidgetPath::Invalidate();
+		AddDamage(widget->GetRect());
+
+		return true;
+	}
+
+	bool GuiManager::RemoveWidget( Widget* widget )
+	{
+		if(!m_widgets.contains(widget)) return false;
+
+		//focus and hover only ever point at top-level widgets
+		if(m_focus == widget) m_focus = NULL;
+		if(m_hoverTarget == widget) m_hoverTarget = NULL;
+
+		UnindexName(widget,widget->GetNameSymbol());
+		m_spatialIndex.Remove(widget);
+		m_widgets.remove(widget);
+		WidgetPath::Invalidate();
+		AddDamage(widget->GetRect());
 		return true;
 	}
 
-	void GuiManager::SetHasFocus( WidgetList::reverse_iterator& i )
+	void GuiManager::SetHasFocus( const std::string& widget_name )
+	{
+		SetHasFocus(GetWidgetByName(widget_name));
+	}
+
+	void GuiManager::SetHasFocus( Widget* widget )
 	{
+		if(!m_widgets.contains(widget)) {
+			return;
+		}
+
 		//the focus is the same widget..
-		if(m_focus == i->second) return;
+		if(m_focus == widget) return;
 
 		//if there was another focus before...he lost focus
 		if(m_focus) {
 			m_focus->m_isFocus = false;
 			m_focus->_HandleOnFocusLost();
+			m_focus->MarkDirty();
 		}
 
-		Widget* widget = i->second;		
-		i++;
-		WidgetList::iterator itr = i.base();
-
-		m_widgets.erase(itr);
-		m_widgets[++index] = widget;
-
-		i = m_widgets.rbegin();
+		//bring it in front of the others
+		m_widgets.raise(widget);
 
 		m_focus = widget;
 		m_focus->m_isFocus = true;
-		m_focus->SetId(i->first);
+		m_focus->MarkDirty();
 		m_focus->OnFocus();
 	}
+	Widget* GuiManager::GetWidgetByName( const std::string& name ) const
+	{
+		uint32 symbol = SymbolTable::Find(name);
+		if(symbol == SymbolTable::Invalid) return NULL;
+
+		return GetWidgetBySymbol(symbol);
+	}
 
-	void GuiManager::SetHasFocus( const std::string& widget_name )
+	Widget* GuiManager::GetWidgetBySymbol( uint32 nameSymbol ) const
 	{
-		Widget* widget = GetWidgetByName(widget_name);
-		if(!widget) {
-			return;
+		NameIndex::const_iterator it = m_nameIndex.find(nameSymbol);
+		if(it == m_nameIndex.end()) {
+			return NULL;
 		}
-		WidgetList::reverse_iterator it(m_widgets.find(widget->GetId()));
-		
-		SetHasFocus(it);
+		return it->second;
 	}
 
-	void GuiManager::SetHasFocus( Widget* widget )
+	void GuiManager::UpdateNameIndex( Widget* widget, uint32 oldName )
 	{
-		if(!widget) {
-			return;
+		//only top-level widgets are indexed here
+		if(!m_widgets.contains(widget)) return;
+		if(oldName == widget->GetNameSymbol()) return;
+
+		UnindexName(widget,oldName);
+
+		//don't overwrite another widget that already uses the name, it's
+		//found first until it goes away(see UnindexName)
+		Widget* other = GetWidgetBySymbol(widget->GetNameSymbol());
+		if(!other) {
+			m_nameIndex[widget->GetNameSymbol()] = widget;
+		} else if(other != widget) {
+			debug_log("A top-level widget called \"%s\" exists already",widget->GetName().c_str());
+			m_shadowedNames[widget->GetNameSymbol()]++;
 		}
+		WidgetPath::Invalidate();
+	}
 
-		WidgetList::reverse_iterator it(m_widgets.find(widget->GetId()));
+	void GuiManager::UnindexName( Widget* widget, uint32 nameSymbol )
+	{
+		NameIndex::iterator it = m_nameIndex.find(nameSymbol);
+		if(it == m_nameIndex.end()) return;
 
-		if(it == m_widgets.rend()) {
-			return;
-		}
-		Widget* w = it->second;
+		NameCount::iterator shadowed = m_shadowedNames.find(nameSymbol);
 		if(it->second != widget) {
+			//the widget was one of those left out of the index
+			if(shadowed != m_shadowedNames.end() && !--shadowed->second) {
+				m_shadowedNames.erase(shadowed);
+			}
 			return;
 		}
+		m_nameIndex.erase(it);
 
-		SetHasFocus(it);
-	}
-	Widget* GuiManager::GetWidgetByName( const std::string& name ) const
-	{
-		//TODO: Expensive O(n) .. fix it!
-		for(WidgetList::const_iterator itr = m_widgets.begin(); 
-			itr != m_widgets.end(); itr++) 
-		{
-			if(itr->second->GetName() == name) {
-				return itr->second;
+		//only a name another widget uses too is searched for
+		if(shadowed == m_shadowedNames.end()) return;
+		for(WidgetList::iterator i = m_widgets.begin(); i != m_widgets.end(); i++) {
+			if((*i) != widget && (*i)->GetNameSymbol() == nameSymbol) {
+				m_nameIndex[nameSymbol] = (*i);
+				break;
 			}
 		}
-		return NULL;
+		if(!--shadowed->second) m_shadowedNames.erase(shadowed);
 	}
 
 	void GuiManager::StartDrag( Widget* widget, sf::Event* event )
@@ -163,8 +220,8 @@ namespace gui {
 	{
 		std::vector<Widget*> chosen;
 		for(WidgetList::const_iterator i = m_widgets.begin(); i != m_widgets.end(); i++){
-			if(i->second->GetType() == type)
-				chosen.push_back(i->second);
+			if((*i)->GetType() == type)
+				chosen.push_back((*i));
 		}
 		return chosen;
 	}
@@ -175,26 +232,60 @@ namespace gui {
 		Widget::s_gui = this;
 		Mediator::s_currentGui = this;
 
+		if(m_recorder) m_recorder->RecordFrame(diff);
+
 		//check if the current focus just died
 		if(m_focus && m_focus->IsDead()) 
 			m_focus = NULL;
 		if(m_hoverTarget && m_hoverTarget->IsDead())
 			m_hoverTarget = NULL;
-		if(m_curDrag && m_curDrag->GetTarget()->IsDead()) {
+
+		//the drag target died(or was freed already)
+		Widget* dragTarget = m_curDrag ? m_curDrag->GetTarget() : NULL;
+		if(m_curDrag && (!dragTarget || dragTarget->IsDead())) {
 			delete m_curDrag;
 			m_curDrag = NULL;
 		}
 
 		_HandleEvents();
 
+		UpdateViewRect();
+
+		//the widgets only record their drawing, it's submitted in batches below
+		m_drawList.Begin(m_backend);
+
 		for(WidgetList::iterator i=m_widgets.begin(); i!= m_widgets.end(); i++) {
-			if(i->second->IsDead()){ 
-				m_freeWidgets.push_back(i->second);
+			Widget* widget = (*i);
+			if(widget->IsDead()){ 
+				m_freeWidgets.push_back(widget);
 			} else {
-				i->second->Update(diff);
-				i->second->Draw();
+				//only widgets that changed since the last frame get updated
+				if(widget->m_needUpdate) {
+					widget->m_needUpdate = false;
+					widget->m_drawCache.Invalidate();
+					widget->Update(diff);
+				}
+			}
+		}
+
+		//drawn after all the updates, so every rect and damage rect is known
+		CullOccluded();
+		if(m_partialRedraw) {
+			DrawDamage();
+		} else {
+			uint32 index = 0;
+			for(WidgetList::iterator i=m_widgets.begin(); i!= m_widgets.end(); i++, index++) {
+				m_occluderCount = m_inFront[index];
+				if(m_occluderCount != OCCLUDED && !(*i)->IsDead()) DrawWidget(*i);
 			}
 		}
+		m_occluderCount = 0;
+
+		//before any dead widget gets freed, the commands point into them
+		m_drawList.Flush();
+
+		m_lastCullStats = m_cullStats;
+		m_cullStats = CullStats();
 
 		//destroy the drag if it stopped
 		if(m_curDrag && m_curDrag->IsStopped()) {
@@ -204,10 +295,8 @@ namespace gui {
 
 		//clear the dead widgets
 		for(uint32 i=0; i<m_freeWidgets.size(); i++) {
-			WidgetList::iterator it = m_widgets.find(m_freeWidgets[i]->GetId());
-			if(it != m_widgets.end()) {
-				delete it->second;
-				m_widgets.erase(it);
+			if(RemoveWidget(m_freeWidgets[i])) {
+				delete m_freeWidgets[i];
 			} else {
 				debug_log("Couldn't delete top-level widget!");
 			}
@@ -216,6 +305,9 @@ namespace gui {
 
 		//we solved the events.. so clear them
 		m_events.clear();
+		m_eventTimes.clear();
+
+		if(m_trackLatency) m_latency.Update(diff);
 
 		//draw the drag if any
 		if(m_curDrag && m_curDrag->IsRunning()) {
@@ -226,9 +318,288 @@ namespace gui {
 		}
 	}
 
+	void GuiManager::DrawWidget( Widget* widget )
+	{
+		//entirely outside the view
+		if(!widget->UpdateVisibleRect(m_viewRect)) return;
+
+		if(!m_retainedMode || !m_drawList.IsRecording()) {
+			widget->Draw();
+			return;
+		}
+
+		//nothing inside changed since it was recorded
+		if(widget->m_drawCache.IsValid()) {
+			m_drawList.AddCache(widget->m_drawCache);
+			return;
+		}
+		//the recording is replayed whatever moves in front of the widget
+		m_occluderCount = 0;
+		m_drawList.BeginCache(widget->m_drawCache);
+		widget->Draw();
+		m_drawList.EndCache(widget->m_drawCache);
+	}
+
+	void GuiManager::DrawDamage()
+	{
+		//the drag is drawn straight to the window, wherever it is
+		if(m_curDrag && m_curDrag->IsRunning()) DamageAll();
+
+		m_drawnDamage.Clear();
+		m_drawnDamage.Add(m_damage);
+		m_drawnDamage.Add(m_lastDamage);
+		m_drawnDamage.Merge();
+
+		m_lastDamage.Clear();
+		m_lastDamage.Add(m_damage);
+		m_damage.Clear();
+
+		const std::vector<Rect>& rects = m_drawnDamage.GetRects();
+		for(uint32 i=0; i<rects.size(); i++) {
+			const Rect& rect = rects[i];
+			m_drawList.PushClip(ToScissor(rect));
+			m_drawList.AddQuad((float)rect.x,(float)rect.y,(float)rect.w,(float)rect.h,m_clearColor);
+
+			Rect clip = GetIntersection(rect,m_viewRect);
+			uint32 index = 0;
+			for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++, index++) {
+				Widget* widget = (*it);
+				m_occluderCount = m_inFront[index];
+				if(m_occluderCount == OCCLUDED || widget->IsDead()) continue;
+
+				//the widget may only be hidden in this damage rect
+				if(!widget->UpdateVisibleRect(clip)) continue;
+				if(m_occlusion.IsOccluded(widget->m_visibleRect,m_occluderCount)) {
+					m_cullStats.occludedWidgets++;
+					continue;
+				}
+				widget->Draw();
+			}
+			m_drawList.PopClip();
+		}
+	}
+
+	void GuiManager::CullOccluded()
+	{
+		m_occlusion.Clear();
+		m_inFront.assign(m_widgets.size(),0);
+		if(!m_occlusionCulling) return;
+
+		//front to back, each widget is tested against the ones in front of it
+		uint32 index = m_widgets.size();
+		for(WidgetList::reverse_iterator it = m_widgets.rbegin(); it != m_widgets.rend(); it++) {
+			Widget* widget = (*it);
+			--index;
+			if(widget->IsDead() || !widget->IsVisible()) continue;
+
+			if(m_occlusion.IsOccluded(GetIntersection(widget->m_rect,m_viewRect))) {
+				m_inFront[index] = OCCLUDED;
+				m_cullStats.occludedWidgets++;
+				continue;
+			}
+			m_inFront[index] = m_occlusion.GetCount();
+
+			Rect opaque = GetIntersection(widget->GetOpaqueRect(),m_viewRect);
+			if(opaque.w) {
+				m_occlusion.Add(opaque);
+				m_cullStats.occluders++;
+			}
+		}
+	}
+
+	bool GuiManager::IsOccluded( const Rect& rect )
+	{
+		if(!m_occluderCount || !m_occlusion.IsOccluded(rect,m_occluderCount)) return false;
+		m_cullStats.occludedChildren++;
+		return true;
+	}
+
+	void GuiManager::SetOcclusionCulling( bool flag )
+	{
+		m_occlusionCulling = flag;
+		DamageAll();
+	}
+
+	bool GuiManager::IsOcclusionCulling() const
+	{
+		return m_occlusionCulling;
+	}
+
+	const GuiManager::CullStats& GuiManager::GetCullStats() const
+	{
+		return m_lastCullStats;
+	}
+
+	GuiManager::CullStats::CullStats() : occluders(0), occludedWidgets(0), occludedChildren(0)
+	{
+
+	}
+
+	void GuiManager::UpdateViewRect()
+	{
+		Rect view(m_window.GetView().GetRect());
+		if(view == m_viewRect) return;
+
+		//what got culled by the old view may show now
+		m_viewRect = view;
+		InvalidateDrawCaches();
+		DamageAll();
+	}
+
+	gui::Rect GuiManager::ToScissor( const Rect& rect ) const
+	{
+		//view coordinates to target pixels, glScissor's origin is bottom-left
+		const sf::FloatRect& view = m_window.GetView().GetRect();
+		double xprc = m_backend->GetWidth() / (double)view.GetWidth();
+		double yprc = m_backend->GetHeight() / (double)view.GetHeight();
+
+		int32 left = (int32)std::floor((rect.x - view.Left) * xprc);
+		int32 right = (int32)std::ceil((rect.x + rect.w - view.Left) * xprc);
+		int32 top = (int32)std::floor((rect.y - view.Top) * yprc);
+		int32 bottom = (int32)std::ceil((rect.y + rect.h - view.Top) * yprc);
+
+		return Rect(left,(int32)m_backend->GetHeight() - bottom,right-left,bottom-top);
+	}
+
+	void GuiManager::SetPartialRedraw( bool flag )
+	{
+		m_partialRedraw = flag;
+		m_damage.Clear();
+		m_lastDamage.Clear();
+		m_drawnDamage.Clear();
+
+		//the first frames have to draw everything
+		if(flag) {
+			DamageAll();
+			m_lastDamage.Add(m_damage);
+		}
+	}
+
+	bool GuiManager::IsPartialRedraw() const
+	{
+		return m_partialRedraw;
+	}
+
+	void GuiManager::AddDamage( const Rect& rect )
+	{
+		if(m_partialRedraw) m_damage.Add(rect);
+	}
+
+	void GuiManager::DamageAll()
+	{
+		AddDamage(Rect(m_window.GetView().GetRect()));
+	}
+
+	const DamageRegion& GuiManager::GetDrawnDamage() const
+	{
+		return m_drawnDamage;
+	}
+
+	void GuiManager::SetClearColor( const sf::Color& color )
+	{
+		m_clearColor = color;
+		DamageAll();
+	}
+
+	const sf::Color& GuiManager::GetClearColor() const
+	{
+		return m_clearColor;
+	}
+
+	void GuiManager::SetRetainedMode( bool flag )
+	{
+		m_retainedMode = flag;
+		InvalidateDrawCaches();
+	}
+
+	bool GuiManager::IsRetainedMode() const
+	{
+		return m_retainedMode;
+	}
+
+	void GuiManager::InvalidateDrawCaches()
+	{
+		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
+			(*it)->m_drawCache.Invalidate();
+		}
+	}
+
 	void GuiManager::RegisterEvent( sf::Event& event )
 	{
+		//recorded before coalescing, so a replay goes through the same path
+		if(m_recorder) m_recorder->RecordEvent(event);
+
+		//the previous position is outdated, nothing happened in between
+		//(the older timestamp is kept, the input was pending since then)
+		if(m_coalesceMouseMoves && event.Type == sf::Event::MouseMoved &&
+		   !m_events.empty() && m_events.back().Type == sf::Event::MouseMoved) 
+		{
+			m_events.back() = event;
+			return;
+		}
 		m_events.push_back(event);
+		if(m_trackLatency) m_eventTimes.push_back(m_clock.GetElapsedTime());
+	}
+
+	void GuiManager::SetLatencyTracking( bool flag )
+	{
+		m_trackLatency = flag;
+		m_eventTimes.clear();
+	}
+
+	bool GuiManager::IsLatencyTracking() const
+	{
+		return m_trackLatency;
+	}
+
+	LatencyStats& GuiManager::GetLatencyStats()
+	{
+		return m_latency;
+	}
+
+	const LatencyStats& GuiManager::GetLatencyStats() const
+	{
+		return m_latency;
+	}
+
+	void GuiManager::RecordLatency( LatencyStats::Stage stage, uint32 eventType, float timestamp )
+	{
+		if(!m_trackLatency || timestamp < 0.f) return;
+
+		m_latency.Record(stage,eventType,m_clock.GetElapsedTime() - timestamp);
+	}
+
+	float GuiManager::GetRoutedTimestamp() const
+	{
+		return m_routedTime;
+	}
+
+	float GuiManager::GetInputTimestamp() const
+	{
+		//events no input caused(layouts, code) aren't timed at all, their
+		//queue delay would skew the input-to-handler numbers
+		if(!m_trackLatency) return -1.f;
+		return m_routedTime;
+	}
+
+	void GuiManager::SetMouseMoveCoalescing( bool flag )
+	{
+		m_coalesceMouseMoves = flag;
+	}
+
+	bool GuiManager::IsMouseMoveCoalescing() const
+	{
+		return m_coalesceMouseMoves;
+	}
+
+	void GuiManager::SetRecorder( InputRecorder* recorder )
+	{
+		m_recorder = recorder;
+	}
+
+	InputRecorder* GuiManager::GetRecorder() const
+	{
+		return m_recorder;
 	}
 
 	void GuiManager::SetTheme( Theme* theme )
@@ -236,7 +607,7 @@ namespace gui {
 		m_theme = theme;
 
 		for(WidgetList::iterator it	= m_widgets.begin(); it != m_widgets.end(); it++) {
-			it->second->ReloadTheme();
+			(*it)->ReloadTheme();
 		}
 	}
 
@@ -280,7 +651,7 @@ namespace gui {
 		}
 
 		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			it->second->SaveLayout(&doc);
+			(*it)->SaveLayout(&doc);
 		}
 		doc.SaveFile(filename);
 	}
@@ -299,6 +670,7 @@ namespace gui {
 			m_theme = NULL;
 		}
 		m_events.clear();
+		m_eventTimes.clear();
 		m_freeWidgets.clear();
 		m_mediator.ClearConnections();
 		m_mediator.GetDispatcher().ClearListeners();
@@ -314,48 +686,26 @@ namespace gui {
 	//returns the path in this form: [0]leaf-[1]child-[2]parent
 	std::stack<Widget*> GuiManager::QueryWidgetPath( const std::string& path ) const
 	{
-		std::vector<std::string> temp;
 		std::stack<Widget*> stack;
-		std::vector<Widget*> helper;
-		Widget* current = NULL;
 
-		ExtractPath(path,temp);
-		
-		if(temp.size()) {
-			current = this->GetWidgetByName(temp[0]);
-			if(!current) {
-				error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", path.c_str(),temp[0]);
-				return stack;
-			}
-		} else return stack;
-
-		helper.push_back(current);
-
-		for(uint32 i=1; i<temp.size(); i++) {
-			current = current->FindChildByName(temp[i]);
-			if(!current) {
-				error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", path.c_str(),temp[i]);
-				return stack;
-			}
-			
-			helper.push_back(current);
+		//walk back from the leaf, the top-level widget ends up on top
+		for(Widget* current = QueryWidget(path); current; current = current->GetParent()) {
+			stack.push(current);
 		}
-
-		for(int i=helper.size()-1; i>=0; i--) {
-			stack.push(helper[i]);
-		}
-
 		return stack;
 	}
 
 	void GuiManager::ClearWidgets()
 	{
-		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			Widget* widget = it->second;
+		while(!m_widgets.empty()) {
+			Widget* widget = m_widgets.top();
+			m_widgets.remove(widget);
 			delete widget;
 		}
-		index = 0;
-		m_widgets.clear();
+		m_nameIndex.clear();
+		m_shadowedNames.clear();
+		m_spatialIndex.Clear();
+		WidgetPath::Invalidate();
 		m_focus = NULL;
 		m_hoverTarget = NULL;
 		if(m_curDrag) {
@@ -389,7 +739,7 @@ namespace gui {
 
 		//save widgets
 		for(WidgetList::iterator it = m_widgets.begin(); it!=m_widgets.end(); it++) {
-			it->second->SaveUI(&doc);
+			(*it)->SaveUI(&doc);
 		}
 		doc.SaveFile(filename);
 	}
@@ -399,80 +749,83 @@ namespace gui {
 		for(uint32 i=0; i<m_freeWidgets.size(); i++) {
 			Widget* widget = m_freeWidgets[i];
 			
-			WidgetList::iterator it = m_widgets.find(widget->GetId());
-			if(it != m_widgets.end()) 
-			{
-				//if the dying widget contains the current focus.. null it!
-				if(widget->ContainsWidget(m_focus)) {
-					m_focus = NULL;
-				} 
-				if(widget->ContainsWidget(m_hoverTarget)) {
-					m_hoverTarget = NULL;
-				}
-				delete it->second;
-				m_widgets.erase(it);
+			//removing it also clears the focus/hover if the widget had them
+			if(RemoveWidget(widget)) {
+				delete widget;
 			}
 		}
 	}
 
 	void GuiManager::_HandleEvents()
 	{
+		//the events registered while tracking was off have no timestamps
+		bool timed = m_trackLatency && m_eventTimes.size() == m_events.size();
+
 		for(int i=0; i<(int)m_events.size(); i++) {
 			sf::Event* curEvent = &m_events[i];
-			WidgetList::reverse_iterator itr;
+			m_routedTime = timed ? m_eventTimes[i] : -1.f;
+
+			//the previous event may have killed the focus or the hover
+			if(m_focus && m_focus->IsDead()) m_focus = NULL;
+			if(m_hoverTarget && m_hoverTarget->IsDead()) m_hoverTarget = NULL;
+
 			switch(curEvent->Type) {
 			case sf::Event::MouseButtonPressed:
-				for(itr=m_widgets.rbegin(); itr!=m_widgets.rend();itr++) {
-					Widget* currentWidget = itr->second;
+			{
+				sf::Vector2f pos = m_window.ConvertCoords(curEvent->MouseButton.X,curEvent->MouseButton.Y);
+				int x = (int)pos.x;
+				int y = (int)pos.y;
+
+				//only the widgets under the cursor, front to back
+				std::vector<Widget*> candidates;
+				m_spatialIndex.QueryPoint(x,y,candidates);
+
+				Widget* clicked = NULL;
+				for(uint32 c=0; c<candidates.size(); c++) {
+					Widget* currentWidget = candidates[c];
 					
 					//skip dead widgets and invisible widgets
 					if(currentWidget->IsDead() || currentWidget->IsHidden()) 
 						continue;
 
-					int x = curEvent->MouseButton.X;
-					int y = curEvent->MouseButton.Y;
-					sf::Vector2f c = m_window.ConvertCoords(x,y);
-					x = (int)c.x;
-					y = (int)c.y;
-
 					//skip widgets if the click happened outside the visible rect
 					if(!IsCollision(currentWidget->NormalizeClipAreaView(),Rect(x,y,1,1))) 
 						continue;
 
 					if(currentWidget->IsCollision(Rect(x,y,1,1)) && currentWidget->m_visible) 
 					{
-						currentWidget->RegisterEvent(curEvent);
-						SetHasFocus(itr);
-						int X = (int)currentWidget->GetPos().x;
-						int Y = (int)currentWidget->GetPos().y;
+						clicked = currentWidget;
+						SetHasFocus(currentWidget);
 
 						//don't initiate drag, widgets will
  						if(currentWidget->CanDrag(x,y)) {
  							StartDrag(currentWidget,curEvent);
  						}
-						
+
+						//down to the clicked child in one pass, this frame
+						currentWidget->RouteEvent(curEvent);
 						break;
 					}
 				}
 				//if a click happened && no widgets were clicked... there's no focus
-				if(itr == m_widgets.rend()) {
+				if(!clicked) {
 					if(m_focus) {
 						m_focus->_LoseFocus();
 
 						m_focus = NULL;
 					}
 				}
-				break;
+			} break;
 			case sf::Event::MouseButtonReleased:
 				{
 					sf::Vector2f a = m_window.ConvertCoords(curEvent->MouseButton.X,curEvent->MouseButton.Y);
 					StopDrag((int)a.x,(int)a.y);
 					if(m_focus) {
 						//focus will received the MouseReleased event even if it's not currently colliding!
-						m_focus->RegisterEvent(curEvent);
+						m_focus->RouteEvent(curEvent);
 
 						//if you're not colliding though.. you will lose focus!
-						if(!m_focus->IsCollision(Rect((int)a.x,(int)a.y,1,1))) {
+						if(m_focus && !m_focus->IsCollision(Rect((int)a.x,(int)a.y,1,1))) {
 							m_focus->_LoseFocus(false);
 							m_focus = NULL;
 						}
@@ -485,44 +838,37 @@ namespace gui {
 					
 					this->MoveDrag(curEvent);
 
-					if(m_focus) 
-						m_focus->RegisterEvent(curEvent);
 					//check for hovering events, they're in order by focus levels, 
 					//so I'll get the widgets in front first
-					Widget* temp = NULL;
-					WidgetList::reverse_iterator it;
-					for(it = m_widgets.rbegin(); it != m_widgets.rend(); it++) {
-						if(!it->second->m_visible) continue;
-
-						if(it->second->IsCollision(Rect((int)a.x,(int)a.y,1,1)) ) {
+					Widget* hovered = GetWidgetAt(a);
 
-							//if it's the same widget.. don't count it
-							if(m_hoverTarget == it->second) {
-								m_hoverTarget->RegisterEvent(curEvent);
-								break;
-							}
+					//the focus gets the moves wherever they are, once if hovered too
+					if(m_focus && m_focus != hovered) 
+						m_focus->RouteEvent(curEvent);
 
-							it->second->OnHover();	
+					Widget* temp = NULL;
+					if(hovered) {
+						//if it's the same widget.. don't count it
+						if(m_hoverTarget != hovered) {
+							hovered->OnHover();	
 
 							temp = m_hoverTarget;
-							m_hoverTarget = it->second;
-							m_hoverTarget->RegisterEvent(curEvent);
-
-							break; //the mouse can only hover over 1 widget at a time..
+							m_hoverTarget = hovered;
 						}
 					}
 					//if hoverTarget was lost
 					if(temp) {
 						temp->OnHoverLost();
-					} else if(it == m_widgets.rend()) {
+					} else if(!hovered) {
 						if(m_hoverTarget) m_hoverTarget->OnHoverLost();
 						m_hoverTarget = NULL;
 					}
+					if(hovered) hovered->RouteEvent(curEvent);
 
 				} break;
 			case sf::Event::KeyPressed:
 			case sf::Event::KeyReleased:
-				if(m_focus) m_focus->RegisterEvent(curEvent);
+				if(m_focus) m_focus->RouteEvent(curEvent);
 				break;
 			case sf::Event::Resized:
 			{
@@ -530,17 +876,20 @@ namespace gui {
 				for(WidgetList::iterator it = m_widgets.begin(); 
 					it != m_widgets.end(); it++) 
 				{
-					it->second->ResizeClipArea(curEvent->Size.Width,curEvent->Size.Height);
-					//it->second->UpdateClipArea();
+					(*it)->ResizeClipArea(curEvent->Size.Width,curEvent->Size.Height);
+					//(*it)->UpdateClipArea();
 				}
+				//the clip rects are in window coordinates
+				InvalidateDrawCaches();
+				DamageAll();
 				m_oldWidth = curEvent->Size.Width;
 				m_oldHeight = curEvent->Size.Height;
 				
 			} break;
-			default: if(m_focus) m_focus->RegisterEvent(curEvent);
+			default: if(m_focus) m_focus->RouteEvent(curEvent);
 			}
 		}
-
+		m_routedTime = -1.f;
 
 	}
 
@@ -549,6 +898,25 @@ namespace gui {
 		return m_window;
 	}
 
+	DrawList& GuiManager::GetDrawList() const
+	{
+		return m_drawList;
+	}
+
+	void GuiManager::SetRenderBackend( RenderBackend* backend )
+	{
+		//the recorded commands belong to the old backend
+		m_drawList.Flush();
+		m_backend = backend ? backend : &m_windowBackend;
+		InvalidateDrawCaches();
+		DamageAll();
+	}
+
+	RenderBackend& GuiManager::GetRenderBackend() const
+	{
+		return *m_backend;
+	}
+
 	void GuiManager::RegisterDrag( Drag* drag )
 	{
 		if(m_curDrag) 
@@ -576,6 +944,10 @@ namespace gui {
 		//if the start wasn't initiated yet, you may return
 		if(m_curDrag->GetStatus() != Drag::Running) return;
 
+		//the target died, the drag gets deleted at the next update
+		Widget* target = m_curDrag->GetTarget();
+		if(!target || target->IsDead()) return;
+
 		////////////////////////////////////////////////////////////////
 		//    Check the current focus target for the new position     //
 		////////////////////////////////////////////////////////////////
@@ -589,7 +961,6 @@ namespace gui {
 		//if there's no parent, the responsible will be the gui mgr
 		if(!m_curDrag->GetTargetParent()) {	
 			//hardcode the movement.. fix?
-			Widget* target = m_curDrag->GetTarget();
 			target->SetPosFromDrag(m_curDrag);
 		} else {
 			Widget* parent = m_curDrag->GetTargetParent();
@@ -605,12 +976,16 @@ namespace gui {
 	Widget* GuiManager::GetWidgetAt( int x, int y ) const
 	{
 		Rect rect = Rect(x,y,1,1);
-		for(WidgetList::const_reverse_iterator it = m_widgets.rbegin(); 
-			it != m_widgets.rend(); it++) 
-		{
-			if(it->second->IsCollision(rect)) {
-				return it->second;
-			}
+		std::vector<Widget*> candidates;
+		m_spatialIndex.QueryPoint(x,y,candidates);
+
+		//the candidates are sorted front to back, the dead ones wait to be
+		//freed and the hidden ones don't get any mouse events
+		for(uint32 i=0; i<candidates.size(); i++) {
+			Widget* widget = candidates[i];
+			if(widget->IsDead() || widget->IsHidden()) continue;
+
+			if(widget->IsCollision(rect)) return widget;
 		}
 		return NULL;
 	}
@@ -619,28 +994,31 @@ namespace gui {
 	{
 		Widget* current = GetWidgetAt(x,y);
 		if(!current) return NULL;
-		if(current == skip) NULL;
+		if(current == skip) return NULL;
 
 		Rect rect = Rect(x,y,1,1);
 
 		//go to the deepest level of composition possible(last widget colliding)
+		std::vector<Widget*> candidates;
 		while(true) {
-			const WidgetList& list = current->GetWidgetList();
-			WidgetList::const_reverse_iterator i;
+			candidates.clear();
+			current->m_spatialIndex.QueryPoint(x,y,candidates);
 
-			for(i = list.rbegin(); i != list.rend(); i++) {
-				if(i->second == skip) continue;
+			Widget* next = NULL;
+			for(uint32 i=0; i<candidates.size(); i++) {
+				if(candidates[i] == skip) continue;
 
-				if(i->second->IsCollision(rect)) {
-					current = i->second;
+				if(candidates[i]->IsCollision(rect)) {
+					next = candidates[i];
 					break;
 				}
 			}
 
-			//if you got to the end of the list and you didn't collide with anything
-			if(i == list.rend()) {
+			//if you didn't collide with anything you're the last one
+			if(!next) {
 				return current;
 			}
+			current = next;
 		}
 	}
 
@@ -673,27 +1051,17 @@ namespace gui {
 
 	Widget* GuiManager::QueryWidget( const std::string& path ) const
 	{
-		std::vector<std::string> temp;
-		Widget* current = NULL;
-
-		ExtractPath(path,temp);
-
-		if(temp.size()) {
-			current = this->GetWidgetByName(temp[0]);
-			if(!current) {
-				error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", path.c_str(),temp[0]);
-				return NULL;
-			}
-		} else return NULL;
+		return QueryWidget(WidgetPath(path));
+	}
 
-		for(uint32 i=1; i<temp.size(); i++) {
-			current = current->FindChildByName(temp[i]);
-			if(!current) {
-				error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", path.c_str(),temp[i]);
-				return NULL;
-			}
+	Widget* GuiManager::QueryWidget( const WidgetPath& path ) const
+	{
+		Widget* widget = path.Resolve(this);
+		if(!widget && !path.IsEmpty()) {
+			error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", 
+				path.GetPath().c_str(), path.GetMissingSegment(this).c_str());
 		}
-		return current;
+		return widget;
 	}
 
 	gui::uint32 GuiManager::GetOldWidth() const
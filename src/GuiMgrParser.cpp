@@ -4,13 +4,14 @@
 #include "../include/gui/Widget.hpp"
 #include "../include/gui/GuiManager.hpp"
 #include "../include/gui/AbstractFactory.hpp"
+#include "../include/gui/SymbolTable.hpp"
 
 namespace gui
 {
 	GuiMgrParser::GuiMgrParser( GuiManager* mgr ) : 
 				m_gui(mgr),m_loadLayout(false)
 	{
-		currentListener = "default";
+		currentListener = SymbolTable::Default;
 	}
 
 	void GuiMgrParser::IterateTags( TiXmlNode* node )
@@ -42,7 +43,7 @@ namespace gui
 				}
 			} else if(strcmp(temp->Value(),"listener") == 0) {
 				//</listener> not inside a <widget>! so it's a gui listner
-				currentListener = "default";
+				currentListener = SymbolTable::Default;
 
 				if(m_tagLoc.size()) 
 					m_tagLoc.pop();
@@ -83,7 +84,8 @@ namespace gui
 				}
 				pAttrib = pAttrib->Next();
 			}
-			currentListener = name;
+			//interned once here, the connections use the id from now on
+			currentListener = SymbolTable::Intern(name);
 			m_tagLoc.push(Listener);
 		} else if(strcmp(element->Value(),"widget") == 0) {
 			switch(GetTagLocation())
@@ -162,16 +164,11 @@ namespace gui
 				//if inside a <widget> tag
 				if(m_widgetInfos.size()) {
 					WidgetInfo& w = m_widgetInfos.top();
-					if(w.m_listenerInfo.find(currentListener) != w.m_listenerInfo.end()) {
-						ListenerInfo& li = w.m_listenerInfo[currentListener];
-						li[eventType].push_back(widgetName);
-					} else {
-						ListenerInfo& li = w.m_listenerInfo[currentListener];
-						li[eventType].push_back(widgetName);
-					}
+					ListenerInfo& li = w.m_listenerInfo[currentListener];
+					li[eventType].push_back(ListenerPath(widgetName,true));
 				} else {
 					ListenerInfo& li = m_guiInfo.m_listenerInfos[currentListener];
-					li[eventType].push_back(widgetName);
+					li[eventType].push_back(ListenerPath(widgetName,false));
 				}
 			} break;
 			default: break;
@@ -236,7 +233,7 @@ namespace gui
 		while(m_tagLoc.size()) {
 			m_tagLoc.pop();
 		}
-		currentListener = "default";
+		currentListener = SymbolTable::Default;
 	}
 
 	//compiles listener/commander connections inside widgets
@@ -244,73 +241,63 @@ namespace gui
 	{
 		if(!info.m_widget) return;
 
-		const LInfo& linfo = info.m_listenerInfo;
+		//the info gets popped below, so its contents are taken first
+		Widget* widget = info.m_widget;
+		LInfo linfo;
+		linfo.swap(info.m_listenerInfo);
 
 		//add widget to gui
 		m_widgetInfos.pop();
 		if(m_widgetInfos.size()) {
 			Widget* parent = m_widgetInfos.top().m_widget;
 			if(!parent) {
-				error_log("Couldn't add widget \"%s\"to non-existing parent!",info.m_widget->GetName().c_str());
+				error_log("Couldn't add widget \"%s\"to non-existing parent!",widget->GetName().c_str());
 			} else {
-				if(!parent->AddWidget(info.m_widget)) {
-					error_log("Couldn't add widget \"%s\" to his parent \"%s\". Maybe duplicate exists?",info.m_widget->GetName().c_str(),parent->GetName().c_str());
+				if(!parent->AddWidget(widget)) {
+					error_log("Couldn't add widget \"%s\" to his parent \"%s\". Maybe duplicate exists?",widget->GetName().c_str(),parent->GetName().c_str());
 				}
 			}
 		} else {
 			
-			if(!m_gui->AddWidget(info.m_widget)) {
-				error_log("Couldn't add widget \"%s\" to his GUI!. Maybe duplicate exists?",info.m_widget->GetName().c_str());
+			if(!m_gui->AddWidget(widget)) {
+				error_log("Couldn't add widget \"%s\" to his GUI!. Maybe duplicate exists?",widget->GetName().c_str());
 			}
 			
 		}
 
-		if(info.m_widget)
-			info.m_widget->SetLoading(false);
+		widget->SetLoading(false);
 
 		if(!linfo.size()) return;
 
-		if(info.m_widget)
-			info.m_widget->SetLoading(true);
+		widget->SetLoading(true);
 
 		//compile listener connections
 		for(LInfo::const_iterator itr = linfo.begin(); itr != linfo.end(); itr++) 
 		{
 			for(ListenerInfo::const_iterator it = itr->second.begin(); it != itr->second.end(); it++) 
 			{		
-				const std::vector<std::string>& paths = it->second;
+				const std::vector<ListenerPath>& paths = it->second;
 				for(uint32 i=0; i<paths.size(); i++) 
 				{
-					std::string path = paths[i];
-					uint32 pos = path.find("this.");
-
-					//build real path
-					if(pos != std::string::npos) {
-						path.replace(pos,4,info.m_widget->GetWidgetPath());
-					} 
-					std::stack<Widget*> hierarchy = m_gui->QueryWidgetPath(path);
-					Widget* temp = NULL;
-					while(hierarchy.size()) {
-						temp = hierarchy.top(); 
-						hierarchy.pop();
-					}
+					//"this." paths start from the widget's children
+					const ListenerPath& path = paths[i];
+					Widget* temp = path.m_relative ? widget->QueryWidget(path.m_path)
+												   : m_gui->QueryWidget(path.m_path);
 					if(!temp) { 
-						error_log("Error compiling widget \"%s\"", info.m_widget->GetWidgetPath());
+						error_log("Error compiling widget \"%s\"", widget->GetWidgetPath().c_str());
 						return;
 					}	
-					info.m_widget->m_mediator.Connect(temp,itr->first,it->first);
+					widget->m_mediator.Connect(temp,itr->first,it->first);
 				}
 			}
 		}
 
-		if(info.m_widget)
-			info.m_widget->SetLoading(false);
+		widget->SetLoading(false);
 	}
 
 	void GuiMgrParser::CompileGui()
 	{
 		//compile listeners
-		std::vector<std::string> temp;
 		LInfo& linfo = m_guiInfo.m_listenerInfos;
 
 		//compile listener connections
@@ -319,19 +306,14 @@ namespace gui
 
 			for(ListenerInfo::iterator it = itr->second.begin(); it != itr->second.end(); it++) 
 			{
-			const std::vector<std::string>& paths = it->second;
+			const std::vector<ListenerPath>& paths = it->second;
 			for(uint32 i=0; i<paths.size(); i++) 
 			{
-				std::string path = paths[i];
+				const WidgetPath& path = paths[i].m_path;
 
-				std::stack<Widget*> hierarchy = m_gui->QueryWidgetPath(path);
-				Widget* temp = NULL;
-				while(hierarchy.size()) {
-					temp = hierarchy.top(); 
-					hierarchy.pop();
-				}
+				Widget* temp = m_gui->QueryWidget(path);
 				if(!temp) { 
-					error_log("Error compiling widget \"%s\"", path.c_str());
+					error_log("Error compiling widget \"%s\"", path.GetPath().c_str());
 					return;
 				}
 				m_gui->m_mediator.Connect(temp,itr->first,it->first);
@@ -340,6 +322,18 @@ namespace gui
 		}
 	}
 
+	GuiMgrParser::ListenerPath::ListenerPath( const std::string& path, bool allowRelative ) 
+		: m_relative(false)
+	{
+		//compiled once here, it's resolved without splitting strings again
+		if(allowRelative && path.compare(0,5,"this.") == 0) {
+			m_relative = true;
+			m_path.Compile(path.substr(5));
+		} else {
+			m_path.Compile(path);
+		}
+	}
+
 	GuiMgrParser::WidgetInfo::WidgetInfo( Widget* widget /*=NULL*/, 
 										  uint32 type /*= WIDGET*/ ) 
 		: m_type(type), m_widget(widget)
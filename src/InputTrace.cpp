@@ -0,0 +1,357 @@
+#include "../include/gui/InputTrace.hpp"
+#include "../include/gui/GuiManager.hpp"
+#include "../include/gui/Debug.hpp"
+#include <string.h>
+
+namespace gui
+{
+	//file layout: the magic, the version, then a list of records
+	static const char TRACE_MAGIC[4] = {'S','G','T','R'};
+	static const uint8 TRACE_VERSION = 1;
+
+	//record tags
+	enum { RECORD_FRAME = 0, RECORD_EVENT = 1 };
+
+	//the buffered records get written once they're this big
+	static const uint32 FLUSH_SIZE = 4096;
+
+	//all the values are stored little endian, regardless of the platform
+	static void WriteU8(std::vector<uint8>& out, uint32 value)
+	{
+		out.push_back(uint8(value));
+	}
+
+	static void WriteU32(std::vector<uint8>& out, uint32 value)
+	{
+		out.push_back(uint8(value));
+		out.push_back(uint8(value >> 8));
+		out.push_back(uint8(value >> 16));
+		out.push_back(uint8(value >> 24));
+	}
+
+	static void WriteFloat(std::vector<uint8>& out, float value)
+	{
+		uint32 bits;
+		memcpy(&bits,&value,sizeof(bits));
+		WriteU32(out,bits);
+	}
+
+	/* Bounds checked reading of the loaded trace */
+	struct TraceReader
+	{
+		TraceReader(const std::vector<uint8>& data) : data(data), pos(0), failed(false) {}
+
+		bool AtEnd() const { return pos >= data.size(); }
+
+		uint32 ReadU8() {
+			if(pos + 1 > data.size()) { failed = true; return 0; }
+			return data[pos++];
+		}
+
+		uint32 ReadU32() {
+			if(pos + 4 > data.size()) { failed = true; pos = data.size(); return 0; }
+			uint32 value = uint32(data[pos]) | (uint32(data[pos+1]) << 8) |
+						   (uint32(data[pos+2]) << 16) | (uint32(data[pos+3]) << 24);
+			pos += 4;
+			return value;
+		}
+
+		float ReadFloat() {
+			uint32 bits = ReadU32();
+			float value;
+			memcpy(&value,&bits,sizeof(value));
+			return value;
+		}
+
+		const std::vector<uint8>& data;
+		uint32 pos;
+		bool failed;
+	};
+
+	InputRecorder::InputRecorder() : m_frames(0), m_events(0), m_frameEnd(0)
+	{
+
+	}
+
+	InputRecorder::~InputRecorder()
+	{
+		Stop();
+	}
+
+	bool InputRecorder::Start( const std::string& filename )
+	{
+		Stop();
+
+		m_file.open(filename.c_str(),std::ios::out | std::ios::binary | std::ios::trunc);
+		if(!m_file.is_open()) {
+			error_log("Couldn't open the input trace \"%s\"!",filename.c_str());
+			return false;
+		}
+		m_frames = m_events = 0;
+		m_buffer.clear();
+		m_buffer.insert(m_buffer.end(),TRACE_MAGIC,TRACE_MAGIC+4);
+		WriteU8(m_buffer,TRACE_VERSION);
+		m_frameEnd = m_buffer.size();
+		return true;
+	}
+
+	void InputRecorder::Stop()
+	{
+		if(!m_file.is_open()) return;
+
+		//events registered after the last update never got handled, so they're dropped
+		Flush();
+		m_file.close();
+		m_buffer.clear();
+	}
+
+	bool InputRecorder::IsRecording() const
+	{
+		return m_file.is_open();
+	}
+
+	void InputRecorder::RecordEvent( const sf::Event& event )
+	{
+		if(!m_file.is_open()) return;
+
+		WriteU8(m_buffer,RECORD_EVENT);
+		WriteU8(m_buffer,event.Type);
+
+		//only the part of the union used by the type is stored
+		switch(event.Type) {
+		case sf::Event::KeyPressed:
+		case sf::Event::KeyReleased:
+			WriteU32(m_buffer,event.Key.Code);
+			WriteU8(m_buffer,(event.Key.Alt ? 1 : 0) | (event.Key.Control ? 2 : 0) | 
+							 (event.Key.Shift ? 4 : 0));
+			break;
+		case sf::Event::TextEntered:
+			WriteU32(m_buffer,event.Text.Unicode);
+			break;
+		case sf::Event::MouseMoved:
+			WriteU32(m_buffer,event.MouseMove.X);
+			WriteU32(m_buffer,event.MouseMove.Y);
+			break;
+		case sf::Event::MouseButtonPressed:
+		case sf::Event::MouseButtonReleased:
+			WriteU8(m_buffer,event.MouseButton.Button);
+			WriteU32(m_buffer,event.MouseButton.X);
+			WriteU32(m_buffer,event.MouseButton.Y);
+			break;
+		case sf::Event::MouseWheelMoved:
+			WriteU32(m_buffer,event.MouseWheel.Delta);
+			break;
+		case sf::Event::JoyMoved:
+			WriteU32(m_buffer,event.JoyMove.JoystickId);
+			WriteU8(m_buffer,event.JoyMove.Axis);
+			WriteFloat(m_buffer,event.JoyMove.Position);
+			break;
+		case sf::Event::JoyButtonPressed:
+		case sf::Event::JoyButtonReleased:
+			WriteU32(m_buffer,event.JoyButton.JoystickId);
+			WriteU32(m_buffer,event.JoyButton.Button);
+			break;
+		case sf::Event::Resized:
+			WriteU32(m_buffer,event.Size.Width);
+			WriteU32(m_buffer,event.Size.Height);
+			break;
+		default:
+			//closed, focus, mouse entered/left: the type is enough
+			break;
+		}
+		m_events++;
+	}
+
+	void InputRecorder::RecordFrame( float diff )
+	{
+		if(!m_file.is_open()) return;
+
+		WriteU8(m_buffer,RECORD_FRAME);
+		WriteFloat(m_buffer,diff);
+		m_frames++;
+		m_frameEnd = m_buffer.size();
+
+		//only whole frames get written, so a crash never leaves half a frame behind
+		if(m_buffer.size() >= FLUSH_SIZE) Flush();
+	}
+
+	void InputRecorder::Flush()
+	{
+		if(!m_frameEnd) return;
+
+		m_file.write((const char*)&m_buffer[0],m_frameEnd);
+		m_file.flush();
+		m_buffer.erase(m_buffer.begin(),m_buffer.begin()+m_frameEnd);
+		m_frameEnd = 0;
+	}
+
+	gui::uint32 InputRecorder::GetFrameCount() const
+	{
+		return m_frames;
+	}
+
+	gui::uint32 InputRecorder::GetEventCount() const
+	{
+		return m_events;
+	}
+
+	InputReplayer::InputReplayer() : m_current(0)
+	{
+
+	}
+
+	bool InputReplayer::Load( const std::string& filename )
+	{
+		m_frames.clear();
+		m_events.clear();
+		m_current = 0;
+
+		std::ifstream is;
+		is.open(filename.c_str(),std::ios::in | std::ios::binary);
+		if(!is.is_open()) {
+			error_log("Couldn't open the input trace \"%s\"!",filename.c_str());
+			return false;
+		}
+		std::vector<uint8> data;
+		char chunk[4096];
+		while(is.read(chunk,sizeof(chunk)) || is.gcount()) {
+			data.insert(data.end(),chunk,chunk+is.gcount());
+		}
+
+		if(data.size() < 5 || memcmp(&data[0],TRACE_MAGIC,4) != 0 || data[4] != TRACE_VERSION) {
+			error_log("\"%s\" isn't a valid input trace!",filename.c_str());
+			return false;
+		}
+
+		TraceReader reader(data);
+		reader.pos = 5;
+
+		Frame frame;
+		frame.time = 0.f;
+		frame.firstEvent = 0;
+		while(!reader.AtEnd() && !reader.failed) {
+			uint32 tag = reader.ReadU8();
+			if(tag == RECORD_FRAME) {
+				frame.diff = reader.ReadFloat();
+				frame.eventCount = m_events.size() - frame.firstEvent;
+				m_frames.push_back(frame);
+
+				frame.time += frame.diff;
+				frame.firstEvent = m_events.size();
+				continue;
+			}
+			if(tag != RECORD_EVENT) {
+				reader.failed = true;
+				break;
+			}
+
+			sf::Event event;
+			memset(&event,0,sizeof(event));
+			event.Type = (sf::Event::EventType)reader.ReadU8();
+
+			switch(event.Type) {
+			case sf::Event::KeyPressed:
+			case sf::Event::KeyReleased:
+			{
+				event.Key.Code = (sf::Key::Code)reader.ReadU32();
+				uint32 flags = reader.ReadU8();
+				event.Key.Alt = (flags & 1) != 0;
+				event.Key.Control = (flags & 2) != 0;
+				event.Key.Shift = (flags & 4) != 0;
+				break;
+			}
+			case sf::Event::TextEntered:
+				event.Text.Unicode = reader.ReadU32();
+				break;
+			case sf::Event::MouseMoved:
+				event.MouseMove.X = (int32)reader.ReadU32();
+				event.MouseMove.Y = (int32)reader.ReadU32();
+				break;
+			case sf::Event::MouseButtonPressed:
+			case sf::Event::MouseButtonReleased:
+				event.MouseButton.Button = (sf::Mouse::Button)reader.ReadU8();
+				event.MouseButton.X = (int32)reader.ReadU32();
+				event.MouseButton.Y = (int32)reader.ReadU32();
+				break;
+			case sf::Event::MouseWheelMoved:
+				event.MouseWheel.Delta = (int32)reader.ReadU32();
+				break;
+			case sf::Event::JoyMoved:
+				event.JoyMove.JoystickId = reader.ReadU32();
+				event.JoyMove.Axis = (sf::Joy::Axis)reader.ReadU8();
+				event.JoyMove.Position = reader.ReadFloat();
+				break;
+			case sf::Event::JoyButtonPressed:
+			case sf::Event::JoyButtonReleased:
+				event.JoyButton.JoystickId = reader.ReadU32();
+				event.JoyButton.Button = reader.ReadU32();
+				break;
+			case sf::Event::Resized:
+				event.Size.Width = reader.ReadU32();
+				event.Size.Height = reader.ReadU32();
+				break;
+			default:
+				if(event.Type >= sf::Event::Count) reader.failed = true;
+				break;
+			}
+			if(!reader.failed) m_events.push_back(event);
+		}
+
+		if(reader.failed) {
+			error_log("The input trace \"%s\" is corrupted, %u frames loaded",
+					  filename.c_str(),(unsigned)m_frames.size());
+		}
+		//events after the last frame were never handled when recording
+		m_events.resize(frame.firstEvent);
+		return !m_frames.empty() || !reader.failed;
+	}
+
+	bool InputReplayer::Step( GuiManager& gui )
+	{
+		if(IsDone()) return false;
+
+		const Frame& frame = m_frames[m_current++];
+		for(uint32 i=0; i<frame.eventCount; i++) {
+			//RegisterEvent takes a non-const event
+			sf::Event event = m_events[frame.firstEvent + i];
+			gui.RegisterEvent(event);
+		}
+		gui.Update(frame.diff);
+		return true;
+	}
+
+	void InputReplayer::Run( GuiManager& gui )
+	{
+		while(Step(gui));
+	}
+
+	void InputReplayer::Rewind()
+	{
+		m_current = 0;
+	}
+
+	bool InputReplayer::IsDone() const
+	{
+		return m_current >= m_frames.size();
+	}
+
+	gui::uint32 InputReplayer::GetFrameCount() const
+	{
+		return m_frames.size();
+	}
+
+	gui::uint32 InputReplayer::GetCurrentFrame() const
+	{
+		return m_current;
+	}
+
+	float InputReplayer::GetFrameDiff( uint32 frame ) const
+	{
+		return frame < m_frames.size() ? m_frames[frame].diff : 0.f;
+	}
+
+	float InputReplayer::GetFrameTime( uint32 frame ) const
+	{
+		return frame < m_frames.size() ? m_frames[frame].time : 0.f;
+	}
+}
@@ -9,7 +9,7 @@ namespace gui {
 		Widget::Draw();
 
 		//then draw the text
-		s_gui->GetWindow().Draw(m_text);
+		s_gui->GetDrawList().Add(m_text);
 	}
 	void Label::SetPos(int x, int y, bool forceMove /*=false*/, bool save /*=true*/)
 	{
@@ -99,6 +99,8 @@ namespace gui {
 	void Label::SetText( const std::string& text )
 	{
 		m_text.SetText(text);
+		MarkDirty();
+		Repaint();
 	}
 
 	std::string Label::GetText() const
@@ -0,0 +1,143 @@
+#include "../include/gui/LatencyStats.hpp"
+#include "../include/gui/Debug.hpp"
+#include <string.h>
+#include <sstream>
+
+namespace gui
+{
+	static const char* STAGE_NAMES[LatencyStats::StageCount] = { "dispatch", "consume" };
+
+	LatencyStats::LatencyStats() : m_dumpInterval(0.f), m_sinceDump(0.f)
+	{
+		Reset();
+	}
+
+	gui::uint32 LatencyStats::TypeIndex( uint32 eventType )
+	{
+		return eventType < (uint32)events::Count ? eventType : (uint32)events::Count;
+	}
+
+	gui::uint32 LatencyStats::BucketIndex( float seconds )
+	{
+		uint32 us = seconds > 0.f ? uint32(seconds * 1000000.f) : 0;
+
+		uint32 bucket = 0;
+		while(us && bucket < BucketCount-1) {
+			us >>= 1;
+			bucket++;
+		}
+		return bucket;
+	}
+
+	void LatencyStats::Record( Stage stage, uint32 eventType, float seconds )
+	{
+		if(stage >= StageCount) return;
+		if(seconds < 0.f) seconds = 0.f;
+
+		Histogram& h = m_histograms[stage][TypeIndex(eventType)];
+		h.buckets[BucketIndex(seconds)]++;
+		h.count++;
+		h.sum += seconds;
+		if(seconds > h.max) h.max = seconds;
+	}
+
+	void LatencyStats::Reset()
+	{
+		memset(m_histograms,0,sizeof(m_histograms));
+	}
+
+	const LatencyStats::Histogram& LatencyStats::Get( Stage stage, uint32 eventType ) const
+	{
+		if(stage >= StageCount) stage = Dispatch;
+		return m_histograms[stage][TypeIndex(eventType)];
+	}
+
+	gui::uint32 LatencyStats::GetCount( Stage stage, uint32 eventType ) const
+	{
+		return Get(stage,eventType).count;
+	}
+
+	float LatencyStats::GetMean( Stage stage, uint32 eventType ) const
+	{
+		const Histogram& h = Get(stage,eventType);
+		return h.count ? float(h.sum / h.count) : 0.f;
+	}
+
+	float LatencyStats::GetMax( Stage stage, uint32 eventType ) const
+	{
+		return Get(stage,eventType).max;
+	}
+
+	float LatencyStats::GetPercentile( Stage stage, uint32 eventType, float percentile ) const
+	{
+		const Histogram& h = Get(stage,eventType);
+		if(!h.count) return 0.f;
+
+		uint32 needed = uint32(percentile * h.count + 0.5f);
+		if(needed < 1) needed = 1;
+
+		uint32 seen = 0;
+		for(uint32 i=0; i<BucketCount; i++) {
+			seen += h.buckets[i];
+			if(seen >= needed) {
+				//the upper bound of the bucket, never above the worst sample
+				float bound = float(1u << i) / 1000000.f;
+				return bound < h.max ? bound : h.max;
+			}
+		}
+		return h.max;
+	}
+
+	void LatencyStats::Dump( std::ostream& os ) const
+	{
+		for(uint32 s=0; s<StageCount; s++) {
+			for(uint32 t=0; t<TypeCount; t++) {
+				if(!m_histograms[s][t].count) continue;
+
+				Stage stage = (Stage)s;
+				os << STAGE_NAMES[s] << " type ";
+				if(t == events::Count) os << "user";
+				else os << t;
+				os << ": n=" << GetCount(stage,t) 
+				   << " mean=" << GetMean(stage,t)*1000.f << "ms"
+				   << " p50=" << GetPercentile(stage,t,0.5f)*1000.f << "ms"
+				   << " p99=" << GetPercentile(stage,t,0.99f)*1000.f << "ms"
+				   << " max=" << GetMax(stage,t)*1000.f << "ms" << std::endl;
+			}
+		}
+	}
+
+	void LatencyStats::Dump() const
+	{
+		std::stringstream ss;
+		Dump(ss);
+
+		//the debug log lines are limited, so write them one by one
+		std::string line;
+		while(std::getline(ss,line)) {
+			debug_log("Latency %s",line.c_str());
+		}
+	}
+
+	void LatencyStats::SetDumpInterval( float interval )
+	{
+		m_dumpInterval = interval > 0.f ? interval : 0.f;
+		m_sinceDump = 0.f;
+	}
+
+	float LatencyStats::GetDumpInterval() const
+	{
+		return m_dumpInterval;
+	}
+
+	void LatencyStats::Update( float diff )
+	{
+		if(!m_dumpInterval) return;
+
+		m_sinceDump += diff;
+		if(m_sinceDump >= m_dumpInterval) {
+			m_sinceDump = 0.f;
+			Dump();
+		}
+	}
+}
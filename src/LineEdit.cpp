@@ -31,15 +31,10 @@ namespace gui
 	{
 		Widget::Draw();
 		if(!m_visible) return;
-		s_gui->GetWindow().Draw(m_visibleText);
+		s_gui->GetDrawList().Add(m_visibleText);
 
-		//make the cursor blink every 300 ms
-		if(m_cursorDiff > 300) {
-			m_cursorDiff = 0;
-			m_cursorShow = !m_cursorShow;
-		}
 		if(m_cursorShow && IsFocus())
-			s_gui->GetWindow().Draw(m_cursor);
+			s_gui->GetDrawList().Add(m_cursor);
 		
 	}
 /*
@@ -82,10 +77,8 @@ namespace gui
 		} else if(event->Key.Code == sf::Key::Right) {
 			if(m_cursorIndex >= m_totalText.size()) return;
 
-			const sf::Input& input = s_gui->GetWindow().GetInput();
-			if(input.IsKeyDown(sf::Key::LControl) ||
-			   input.IsKeyDown(sf::Key::RControl)) 
-			{
+			//from the event, not the live keyboard, so replayed traces behave the same
+			if(event->Key.Control) {
 				//calculate the displacement
 				int temp = m_cursorIndex;
 				m_cursorIndex = _FindCursorPos(m_totalText,m_cursorIndex,1);
@@ -111,9 +104,7 @@ namespace gui
 
 		} else if(event->Key.Code == sf::Key::Left) {
 
-			const sf::Input& input = s_gui->GetWindow().GetInput();
-			if(input.IsKeyDown(sf::Key::LControl) ||
-				input.IsKeyDown(sf::Key::RControl)) {
+			if(event->Key.Control) {
 					m_cursorIndex = _FindCursorPos(m_totalText,m_cursorIndex,-1);
 					m_cursorStartIndex = 0;
 					m_visibleChars = m_totalText.size();
@@ -223,6 +214,23 @@ namespace gui
 	{
 		Widget::Update(diff);
 		m_cursorDiff += diff;
+
+		//make the cursor blink every 300 ms, only the cursor needs redrawing
+		if(m_cursorDiff > 300) {
+			m_cursorDiff = 0;
+			m_cursorShow = !m_cursorShow;
+			if(IsFocus()) Repaint(GetCursorRect());
+		}
+
+		//the cursor keeps blinking while focused
+		if(IsFocus()) MarkDirty();
+	}
+
+	gui::Rect LineEdit::GetCursorRect() const
+	{
+		//the line is centered on its position, pad it for the thickness
+		const sf::Vector2f& pos = m_cursor.GetPosition();
+		return Rect((int32)pos.x-3,m_rect.y,6,m_rect.h);
 	}
 
 	void LineEdit::SetVisibleText()
@@ -467,6 +475,8 @@ namespace gui
 		m_visibleText.SetText(temp);
 
 		_SetCursorPos();
+		MarkDirty();
+		Repaint();
 	}
 
 	const std::string& LineEdit::GetText() const
@@ -14,16 +14,20 @@ namespace gui
 	}
 
 
-	Mediator::Mediator()
+	Mediator::Mediator() : m_owner(NULL)
 	{
 		m_freeEvent = NULL;	
-		m_listeners["default"] = Listener();
-		m_currentListener = &m_listeners["default"];
+		m_currentListener = GetListener(SymbolTable::Default);
 	}
 
 	bool Mediator::SwitchListener( const std::string& listener /* = "default" */) const
 	{
-		m_currentListener = &m_listeners[listener];
+		return SwitchListener(SymbolTable::Intern(listener));
+	}
+
+	bool Mediator::SwitchListener( uint32 listener ) const
+	{
+		m_currentListener = GetListener(listener);
 		return true;
 	}
 
@@ -31,35 +35,108 @@ namespace gui
 	{
 		if(!m_currentListener) return NULL;
 		
-		//free memory for events when count reaches 0
+		//drop the reference to the previous event, frees it if it was the last one
 		if(m_freeEvent) {
-			delete m_freeEvent;
+			m_freeEvent->Release();
 			m_freeEvent = NULL;
 		}
 
-		Event* temp = m_currentListener->pop();
-		if(!temp) return NULL;
+		//the listener's reference is kept until the next call
+		m_freeEvent = m_currentListener->pop();
 
-		if(temp->m_refCount == 0)
-			m_freeEvent = temp;
-		
-		return temp;
+		if(m_freeEvent && m_freeEvent->m_timestamp >= 0.f && s_currentGui) {
+			s_currentGui->RecordLatency(LatencyStats::Consume,m_freeEvent->GetType(),
+										m_freeEvent->m_timestamp);
+		}
+		return m_freeEvent;
 	}
 
 	Listener* Mediator::GetListener( const std::string& listener /*= "default"*/ ) const
 	{
-		return &m_listeners[listener];
+		return GetListener(SymbolTable::Intern(listener));
+	}
+
+	Listener* Mediator::GetListener( uint32 listener ) const
+	{
+		if(Listener* l = FindListener(listener)) return l;
+
+		Listener* l = new Listener();
+		l->m_owner = m_owner;
+		m_listeners.push_back(std::make_pair(listener,l));
+		return l;
+	}
+
+	Listener* Mediator::FindListener( uint32 listener ) const
+	{
+		for(uint32 i=0; i<m_listeners.size(); i++) {
+			if(m_listeners[i].first == listener) return m_listeners[i].second;
+		}
+		return NULL;
+	}
+
+	void Mediator::SetCoalescing( bool flag, const std::string& listener /*= "default"*/ )
+	{
+		GetListener(listener)->SetCoalescing(flag);
+	}
+
+	void Mediator::SetOwner( Widget* owner )
+	{
+		m_owner = owner;
+		for(ListnerList::iterator it = m_listeners.begin(); it != m_listeners.end(); it++) {
+			it->second->m_owner = owner;
+		}
 	}
 
 	void Mediator::PostEvent( Event* event )
 	{
+		if(!event) return;
+
+		//stamped with the input that caused it, for the latency stats
+		if(s_currentGui && event->m_timestamp < 0.f) {
+			event->m_timestamp = s_currentGui->GetInputTimestamp();
+		}
+
+		//hold the event while dispatching, if no listener took it, it's freed here
+		event->AddRef();
 		m_dispatcher.DispatchEvent(event);
+		event->Release();
+	}
+
+	bool Mediator::HasListeners( uint32 eventType ) const
+	{
+		return m_dispatcher.CaresAbout(eventType);
 	}
 
 	Mediator::~Mediator()
 	{
 		ConsumeEvents();
 		ClearConnections();
+		ClearSignals();
+
+		for(uint32 i=0; i<m_listeners.size(); i++) {
+			delete m_listeners[i].second;
+		}
+	}
+
+	SignalBase* Mediator::FindSignal( uint32 eventType ) const
+	{
+		for(uint32 i=0; i<m_signals.size(); i++) {
+			if(m_signals[i].first == eventType) return m_signals[i].second;
+		}
+		return NULL;
+	}
+
+	void Mediator::AddSignal( uint32 eventType, SignalBase* signal )
+	{
+		m_signals.push_back(std::make_pair(eventType,signal));
+	}
+
+	void Mediator::ClearSignals()
+	{
+		for(uint32 i=0; i<m_signals.size(); i++) {
+			delete m_signals[i].second;
+		}
+		m_signals.clear();
 	}
 
 	bool Mediator::IsActive() const
@@ -69,7 +146,7 @@ namespace gui
 
 	bool Mediator::SetDefaultListener() const
 	{
-		return SwitchListener("default");
+		return SwitchListener(SymbolTable::Default);
 	}
 
 	//should receive a <widget> element node/ or a document node
@@ -80,7 +157,7 @@ namespace gui
 		for(ConnectionList::const_iterator it = m_connections.begin(); 
 			it != m_connections.end(); it++)
 		{
-			const std::string& listener_name = it->first;
+			const std::string& listener_name = SymbolTable::GetName(it->first);
 			TiXmlElement* elem = new TiXmlElement("listener");
 			elem->SetAttribute("name",listener_name.c_str());
 
@@ -113,6 +190,13 @@ namespace gui
 	bool Mediator::Connect( Widget* widget, const std::string& my_listener, 
 							uint32 eventType, 
 							bool saveConnection /*= true*/ )
+	{
+		return Connect(widget,SymbolTable::Intern(my_listener),eventType,saveConnection);
+	}
+
+	bool Mediator::Connect( Widget* widget, uint32 my_listener, 
+							uint32 eventType, 
+							bool saveConnection /*= true*/ )
 	{
 		if(!widget) return false;
 
@@ -136,15 +220,48 @@ namespace gui
 							my_listner, uint32 eventType, 
 							bool saveConnection /*= true*/ )
 	{
-		if(!s_currentGui) {
+		return Connect(QueryRelative(path), my_listner,eventType,saveConnection);
+	}
+
+	bool Mediator::Connect( const WidgetPath& path, const std::string& my_listener, 
+							uint32 eventType, bool saveConnection /*= true*/ )
+	{
+		return Connect(QueryRelative(path), my_listener, eventType, saveConnection);
+	}
+
+	bool Mediator::Connect( Widget* current, const WidgetPath& path, const std::string& my_listener, uint32 eventType, bool saveConnection /*= true*/ )
+	{
+		if(!current) {
 			error_log("Unable to complete query! Couldn't find the current gui manager!");
 			return false;
 		}
-		std::string temp = m_currentPath.size() ? m_currentPath + "." + path 
-												: path; 
-		Widget* w = s_currentGui->QueryWidget(temp);
+		Widget* w = current->QueryWidget(path);
+		return Connect(w, my_listener, eventType, saveConnection);
+	}
+
+	Widget* Mediator::QueryRelative( const std::string& path ) const
+	{
+		return QueryRelative(WidgetPath(path));
+	}
+
+	Widget* Mediator::QueryRelative( const WidgetPath& path ) const
+	{
+		if(!s_currentGui) {
+			error_log("Unable to complete query! Couldn't find the current gui manager!");
+			return NULL;
+		}
+		if(m_currentWidgetPath.IsEmpty()) {
+			return s_currentGui->QueryWidget(path);
+		}
 
-		return Connect(w, my_listner,eventType,saveConnection);
+		//resolve the current widget first(cached), then the rest from it
+		Widget* current = m_currentWidgetPath.Resolve(s_currentGui);
+		if(!current) {
+			error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", 
+				path.GetPath().c_str(), m_currentPath.c_str());
+			return NULL;
+		}
+		return current->QueryWidget(path);
 	}
 
 	bool Mediator::Connect( Widget* current, const std::string& path, const std::string& my_listener, uint32 eventType, bool saveConnection /*= true*/ )
@@ -169,41 +286,63 @@ namespace gui
 
 	void Mediator::ConsumeEvents()
 	{
-		for(ListnerList::iterator it = m_listeners.begin(); it != m_listeners.end(); it++) {
-			//free events from all listeners
-			SwitchListener(it->first);
+		//the last event returned by GetEvent()
+		if(m_freeEvent) {
+			m_freeEvent->Release();
+			m_freeEvent = NULL;
+		}
 
-			while(GetEvent()) {
-				//consume events.. so they get freed
-			}
+		//free events from all listeners
+		for(ListnerList::iterator it = m_listeners.begin(); it != m_listeners.end(); it++) {
+			it->second->clear();
 		}
 	}
 
 	void Mediator::SetCurrentPath( const std::string& path )
 	{
 		m_currentPath = path;
+		m_currentWidgetPath.Compile(path);
 	}
 
 	bool Mediator::Disconnect( Widget* with, const std::string& my_listener, uint32 eventType )
+	{
+		uint32 listener = SymbolTable::Find(my_listener);
+		if(listener == SymbolTable::Invalid) return false;
+
+		return Disconnect(with,listener,eventType);
+	}
+
+	bool Mediator::Disconnect( Widget* with, uint32 my_listener, uint32 eventType )
 	{
 		if(!with) return false;
 		Dispatcher& d = with->GetMediator().GetDispatcher();
-		
-		return d.UnRegisterListner(eventType,GetListener(my_listener));
+
+		//a listener that doesn't exist can't be connected
+		Listener* listener = FindListener(my_listener);
+		if(!listener) return false;
+
+		return d.UnRegisterListner(eventType,listener);
 	}
 
 	bool Mediator::Disconnect( const std::string& path, const std::string& my_listner, uint32 eventType )
 	{
-		if(!s_currentGui) {
+		return Disconnect(QueryRelative(path), my_listner,eventType);
+	}
+
+	bool Mediator::Disconnect( const WidgetPath& path, const std::string& my_listener, uint32 eventType )
+	{
+		return Disconnect(QueryRelative(path), my_listener, eventType);
+	}
+
+	bool Mediator::Disconnect( Widget* current, const WidgetPath& path, const std::string& my_listener, uint32 eventType )
+	{
+		if(!current) {
 			error_log("Unable to complete query! Couldn't find the current gui manager!");
 			return false;
 		}
-		std::string temp = m_currentPath.size() ? m_currentPath + "." + path 
-							: path; 
-
-		Widget* w = s_currentGui->QueryWidget(temp);
+		Widget* w = current->QueryWidget(path);
 
-		return Disconnect(w, my_listner,eventType);
+		return Disconnect(w, my_listener, eventType);
 	}
 
 	bool Mediator::Disconnect( Widget* current, const std::string& path, const std::string& my_listener, uint32 eventType )
@@ -217,104 +356,268 @@ namespace gui
 		return Disconnect(w, my_listener, eventType);
 	}
 
-	bool Dispatcher::CaresAbout( uint32 eventType )
+	Dispatcher::Dispatcher() : m_mask(0), m_anyCount(0)
+	{
+
+	}
+
+	Dispatcher::ListenerVector* Dispatcher::GetListeners( uint32 eventType, bool create )
+	{
+		//uint32(-1) stands for any event
+		if(eventType == uint32(-1)) return &m_anyListeners;
+		if(eventType < events::Count) return &m_listeners[eventType];
+
+		std::map<uint32, ListenerVector>::iterator it = m_otherListeners.find(eventType);
+		if(it != m_otherListeners.end()) return &it->second;
+
+		return create ? &m_otherListeners[eventType] : NULL;
+	}
+
+	bool Dispatcher::CaresAboutOther( uint32 eventType ) const
+	{
+		std::map<uint32, ListenerVector>::const_iterator it = m_otherListeners.find(eventType);
+		return (it != m_otherListeners.end() && !it->second.empty());
+	}
+
+	void Dispatcher::UpdateMask( uint32 eventType )
 	{
-		return ((m_listeners.find(eventType) != m_listeners.end()) ||	//particular interests...
-				(m_listeners[uint32(-1)].size()));						//general purpose.. cares about any event!
+		if(eventType == uint32(-1)) {
+			m_anyCount = m_anyListeners.size();
+		} else if(eventType < events::Count) {
+			if(m_listeners[eventType].empty())
+				m_mask &= ~(1u << eventType);
+			else m_mask |= (1u << eventType);
+		}
 	}
 
 	void Dispatcher::DispatchEvent( Event* event )
 	{
 		if(!event) return;
 
-		std::map<uint32,std::vector<Listener*> >::iterator it = m_listeners.find(event->GetType());
-		
-		//if nobody cares about this event.. free the memory
-		if(it == m_listeners.end()) {
-			const std::vector<Listener*>& generalListeners = m_listeners[uint32(-1)];
-
-			if(!generalListeners.size()) {
-				delete event;
-				return;
-			}
+		//if nobody cares about this event.. the poster's reference frees it
+		ListenerVector* listeners = GetListeners(event->GetType(),false);
+		if(!listeners || listeners->empty()) {
 			//if some cares about any event.. send it to it
-			for(uint32 i=0; i<generalListeners.size(); i++) {
-				generalListeners[i]->push(event);
+			for(uint32 i=0; i<m_anyListeners.size(); i++) {
+				m_anyListeners[i]->push(event);
 			}
-			
 		} else {
 			//dispatch event to all interested listeners
-			for(uint32 i=0; i<it->second.size(); i++) {
-				it->second[i]->push(event);
+			for(uint32 i=0; i<listeners->size(); i++) {
+				(*listeners)[i]->push(event);
 			}
 		}
 	}
 
 	void Dispatcher::RegisterListener( Listener* listener )
 	{
-		uint32 i = (uint32)-1; //max value
-		m_listeners[i].push_back(listener);
+		RegisterListener((uint32)-1,listener); //max value
 	}
 
 	void Dispatcher::RegisterListener( uint32 eventType, Listener* listener )
 	{
-		m_listeners[eventType].push_back(listener);
+		GetListeners(eventType,true)->push_back(listener);
+		UpdateMask(eventType);
 	}
 
 	void Dispatcher::ClearListeners()
 	{
-		m_listeners.clear();
+		for(uint32 i=0; i<events::Count; i++) {
+			m_listeners[i].clear();
+		}
+		m_anyListeners.clear();
+		m_otherListeners.clear();
+		m_mask = 0;
+		m_anyCount = 0;
 	}
 
 	bool Dispatcher::UnRegisterListner( uint32 eventType, Listener* listener )
 	{
-		std::map<uint32, std::vector<Listener*> >::iterator it;
-		it = m_listeners.find(eventType);
-		if(it == m_listeners.end()) return false;
+		ListenerVector* v = GetListeners(eventType,false);
+		if(!v) return false;
 
-		std::vector<Listener*>& v = it->second;
-		for(std::vector<Listener*>::const_iterator i=v.begin(); i != v.end(); i++) {
+		for(ListenerVector::iterator i=v->begin(); i != v->end(); i++) {
 			if(listener == (*i)) {
-				v.erase(i);
+				v->erase(i);
+				UpdateMask(eventType);
 				return true;
 			}
 		}
 		return false;
 	}
 
+	Listener::Listener( uint32 capacity /*= 64*/, OverflowPolicy policy /*= DropOldest*/ ) :
+		m_capacity(capacity ? capacity : 1), m_head(0), m_count(0), 
+		m_policy(policy), m_coalesce(false), m_owner(NULL)
+	{
+
+	}
+
+	Listener::Stats::Stats() : highWaterMark(0), drops(0), coalesces(0)
+	{
+
+	}
+
 	void Listener::push(Event* e)
 	{
-		//clear all other events 
-		if(m_events.size() > m_maxCount) {
-			while(m_events.size()) {
-				Event* e = pop();
+		if(!e) return;
+		if(m_buffer.empty()) m_buffer.resize(m_capacity,NULL);
 
-				//if no one else cares about this event.. go ahead and free it
-				if(e->m_refCount == 0) {
-					delete e;
-				}
+		if(m_coalesce && Merge(e)) {
+			m_stats.coalesces++;
+			if(m_owner) m_owner->MarkDirty();
+			return;
+		}
+
+		if(m_count == m_buffer.size()) {
+			switch(m_policy) {
+				case DropNewest:
+					m_stats.drops++;
+					return;
+				case Grow:
+					Reallocate(m_buffer.size()*2);
+					break;
+				case Coalesce:
+					if(Replace(e)) {
+						m_stats.coalesces++;
+						if(m_owner) m_owner->MarkDirty();
+						return;
+					}
+					//nothing of the same type pending, make room like DropOldest
+				case DropOldest:
+				default:
+					//frees it if no one else holds it
+					pop()->Release();
+					m_stats.drops++;
+					break;
 			}
 		}
-		m_events.push(e);
-		e->m_refCount++;
+		m_buffer[(m_head + m_count) % m_buffer.size()] = e;
+		m_count++;
+		e->AddRef();
+
+		if(m_count > m_stats.highWaterMark) m_stats.highWaterMark = m_count;
+
+		//the owner has to run its update to consume the event
+		if(m_owner) m_owner->MarkDirty();
 	}
+
 	Event* Listener::pop()
 	{
-		if(!m_events.size()) return NULL;
+		if(!m_count) return NULL;
+
+		//the caller takes over the listener's reference
+		Event* e = m_buffer[m_head];
+		m_buffer[m_head] = NULL;
+		m_head = (m_head + 1) % m_buffer.size();
+		m_count--;
+		return e;
+	}
 
-		Event* e = m_events.front();
-		if(e->m_refCount > 0) {
-			e->m_refCount--;
+	void Listener::clear()
+	{
+		while(Event* e = pop()) {
+			e->Release();
+		}
+		m_head = 0;
+	}
+
+	bool Listener::Replace( Event* e )
+	{
+		//the newest pending event of the same type gets replaced
+		for(uint32 i=m_count; i>0; i--) {
+			Event*& pending = m_buffer[(m_head + i - 1) % m_buffer.size()];
+			if(pending->GetType() == e->GetType()) {
+				e->AddRef();
+				pending->Release();
+				pending = e;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Listener::Merge( Event* e )
+	{
+		for(uint32 i=m_count; i>0; i--) {
+			Event* pending = m_buffer[(m_head + i - 1) % m_buffer.size()];
+
+			//events shared with other listeners are left alone
+			if(pending->m_refCount == 1 && pending->Coalesce(e)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Listener::Reallocate( uint32 capacity )
+	{
+		//unroll the pending events at the start of the new buffer
+		std::vector<Event*> buffer(capacity,NULL);
+		for(uint32 i=0; i<m_count; i++) {
+			buffer[i] = m_buffer[(m_head + i) % m_buffer.size()];
+		}
+		m_buffer.swap(buffer);
+		m_capacity = capacity;
+		m_head = 0;
+	}
+
+	gui::uint32 Listener::size() const
+	{
+		return m_count;
+	}
+
+	bool Listener::empty() const
+	{
+		return m_count == 0;
+	}
+
+	void Listener::SetCapacity( uint32 capacity )
+	{
+		if(capacity < m_count) capacity = m_count;
+		if(!capacity) capacity = 1;
+
+		if(m_buffer.empty()) {
+			m_capacity = capacity;
 		} else {
-			error_log("Tried to decrease refCount but it is 0. It should get freed!");
+			Reallocate(capacity);
 		}
-		m_events.pop();
-		return e;
 	}
 
-	Listener::Listener() : m_maxCount(50) //max allowed events
+	gui::uint32 Listener::GetCapacity() const
 	{
+		return m_capacity;
+	}
+
+	void Listener::SetCoalescing( bool flag )
+	{
+		m_coalesce = flag;
+	}
+
+	bool Listener::IsCoalescing() const
+	{
+		return m_coalesce;
+	}
 
+	void Listener::SetOverflowPolicy( OverflowPolicy policy )
+	{
+		m_policy = policy;
+	}
+
+	gui::Listener::OverflowPolicy Listener::GetOverflowPolicy() const
+	{
+		return m_policy;
+	}
+
+	const Listener::Stats& Listener::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void Listener::ResetStats()
+	{
+		m_stats = Stats();
+		m_stats.highWaterMark = m_count;
 	}
 
 
@@ -0,0 +1,78 @@
+#include "../include/gui/OcclusionBuffer.hpp"
+
+namespace gui
+{
+	//past this many uncovered parts the rect is assumed visible
+	static const uint32 MAX_PARTS = 32;
+
+	OcclusionBuffer::OcclusionBuffer( uint32 maxOccluders /*= 16*/ ) :
+		m_maxOccluders(maxOccluders)
+	{
+
+	}
+
+	void OcclusionBuffer::Add( const Rect& rect )
+	{
+		if(rect.w <= 0 || rect.h <= 0) return;
+		if(m_rects.size() >= m_maxOccluders) return;
+		m_rects.push_back(rect);
+	}
+
+	void OcclusionBuffer::Clear()
+	{
+		m_rects.clear();
+	}
+
+	gui::uint32 OcclusionBuffer::GetCount() const
+	{
+		return m_rects.size();
+	}
+
+	const std::vector<Rect>& OcclusionBuffer::GetRects() const
+	{
+		return m_rects;
+	}
+
+	bool OcclusionBuffer::IsOccluded( const Rect& rect, uint32 count ) const
+	{
+		if(rect.w <= 0 || rect.h <= 0) return false;
+		if(count > m_rects.size()) count = m_rects.size();
+
+		//cut every occluder out of the rect, whatever is left is visible
+		m_parts.clear();
+		m_parts.push_back(rect);
+		for(uint32 i=0; i<count && !m_parts.empty(); i++) {
+			const Rect& occluder = m_rects[i];
+			m_nextParts.clear();
+
+			for(uint32 j=0; j<m_parts.size(); j++) {
+				const Rect& part = m_parts[j];
+				Rect hit = GetIntersection(part,occluder);
+				if(!hit.w) {
+					m_nextParts.push_back(part);
+					continue;
+				}
+
+				//the bands above and below the hit, then left and right of it
+				int32 bottom = part.y + part.h, hitBottom = hit.y + hit.h;
+				if(hit.y > part.y) 
+					m_nextParts.push_back(Rect(part.x,part.y,part.w,hit.y-part.y));
+				if(hitBottom < bottom) 
+					m_nextParts.push_back(Rect(part.x,hitBottom,part.w,bottom-hitBottom));
+				if(hit.x > part.x) 
+					m_nextParts.push_back(Rect(part.x,hit.y,hit.x-part.x,hit.h));
+				if(hit.x + hit.w < part.x + part.w) 
+					m_nextParts.push_back(Rect(hit.x+hit.w,hit.y,part.x+part.w-hit.x-hit.w,hit.h));
+			}
+
+			if(m_nextParts.size() > MAX_PARTS) return false;
+			m_parts.swap(m_nextParts);
+		}
+		return m_parts.empty();
+	}
+
+	bool OcclusionBuffer::IsOccluded( const Rect& rect ) const
+	{
+		return IsOccluded(rect,m_rects.size());
+	}
+}
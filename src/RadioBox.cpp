@@ -31,8 +31,8 @@ namespace gui
 
 		WidgetList& Ui = m_parent->GetWidgetList();
 		for(WidgetList::const_iterator i = Ui.begin(); i != Ui.end(); i++) {
-			if(i->second->GetType() == RADIOBOX && i->second != this) {
-				((RadioBox*)i->second)->UnCheck();
+			if((*i)->GetType() == RADIOBOX && (*i) != this) {
+				((RadioBox*)(*i))->UnCheck();
 			}
 		}		
 	}	
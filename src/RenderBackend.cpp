@@ -0,0 +1,71 @@
+#include "../include/gui/RenderBackend.hpp"
+
+namespace gui
+{
+	RenderBackend::~RenderBackend()
+	{
+
+	}
+
+	SfmlBackend::QuadBatch::QuadBatch( const ColorVertex* vertices, uint32 count ) :
+		m_vertices(vertices), m_count(count)
+	{
+
+	}
+
+	void SfmlBackend::QuadBatch::Render( sf::RenderTarget& ) const
+	{
+		//same states as sf::Shape, the vertices are already in world coordinates
+		glDisable(GL_TEXTURE_2D);
+
+		glBegin(GL_QUADS);
+		for(uint32 i=0; i<m_count; i++) {
+			const ColorVertex& v = m_vertices[i];
+			glColor4ub(v.color.r,v.color.g,v.color.b,v.color.a);
+			glVertex2f(v.x,v.y);
+		}
+		glEnd();
+	}
+
+	SfmlBackend::SfmlBackend( sf::RenderWindow& window ) : m_window(&window), m_scissor(false)
+	{
+
+	}
+
+	sf::RenderWindow& SfmlBackend::GetWindow() const
+	{
+		return *m_window;
+	}
+
+	gui::uint32 SfmlBackend::GetWidth() const
+	{
+		return m_window->GetWidth();
+	}
+
+	gui::uint32 SfmlBackend::GetHeight() const
+	{
+		return m_window->GetHeight();
+	}
+
+	void SfmlBackend::SetScissor( const Rect* scissor )
+	{
+		if(!scissor) {
+			if(m_scissor) glDisable(GL_SCISSOR_TEST);
+			m_scissor = false;
+			return;
+		}
+		if(!m_scissor) glEnable(GL_SCISSOR_TEST);
+		glScissor(scissor->x, scissor->y, scissor->w, scissor->h);
+		m_scissor = true;
+	}
+
+	void SfmlBackend::DrawQuads( const ColorVertex* vertices, uint32 count )
+	{
+		if(count) m_window->Draw(QuadBatch(vertices,count));
+	}
+
+	void SfmlBackend::Draw( const sf::Drawable& drawable )
+	{
+		m_window->Draw(drawable);
+	}
+}
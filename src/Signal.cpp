@@ -0,0 +1,9 @@
+#include "../include/gui/Signal.hpp"
+
+namespace gui
+{
+	SignalBase::~SignalBase()
+	{
+
+	}
+}
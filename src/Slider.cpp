@@ -49,9 +49,11 @@ namespace gui
 		}
 		m_curValue = value;
 
-		m_mediator.PostEvent(new OnValueChanged(this,value));
+		m_mediator.PostEvent<gui::OnValueChanged>(this,value);
 
 		CalculateSliderPos();
+		MarkDirty();
+		Repaint();
 	}
 
 	void Slider::SetLimits( int lower, int upper )
@@ -81,7 +83,7 @@ namespace gui
 	{
 		Widget::OnClickPressed(event);
 
-		m_needUpdate = true;
+		MarkDirty();
 
 		sf::Vector2f pos((float)event->MouseButton.X,
 						 (float)event->MouseButton.Y);
@@ -122,7 +124,7 @@ namespace gui
 	{
 		Widget::Draw();
 
-		s_gui->GetWindow().Draw(m_cursor);
+		s_gui->GetDrawList().Add(m_cursor);
 	}
 	void Slider::OnClickReleased(sf::Event *event)
 	{
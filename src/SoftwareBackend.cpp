@@ -0,0 +1,324 @@
+#include "../include/gui/SoftwareBackend.hpp"
+#include "../include/gui/GlyphAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace gui
+{
+	//twice the signed area of the triangle, > 0 if p is left of p0->p1
+	static float Edge(float x0, float y0, float x1, float y1, float px, float py)
+	{
+		return (x1-x0)*(py-y0) - (y1-y0)*(px-x0);
+	}
+
+	static uint8 Modulate(uint8 first, uint8 second)
+	{
+		return uint8((uint32(first) * uint32(second)) / 255);
+	}
+
+	SoftwareBackend::Texture::Texture( const sf::Image& image ) : image(image),
+		scaleX((float)image.GetWidth()), scaleY((float)image.GetHeight())
+	{
+		//the texture can be bigger than the image(power of 2 sizes), and
+		//smooth images have their coordinates on the texel centers
+		sf::FloatRect full = image.GetTexCoords(sf::IntRect(0,0,image.GetWidth(),image.GetHeight()));
+		if(full.Left > 0.f) {
+			scaleX = 0.5f / full.Left;
+			scaleY = 0.5f / full.Top;
+		} else if(full.Right > 0.f && full.Bottom > 0.f) {
+			scaleX = image.GetWidth() / full.Right;
+			scaleY = image.GetHeight() / full.Bottom;
+		}
+	}
+
+	sf::Color SoftwareBackend::Texture::Sample( float x, float y ) const
+	{
+		if(!image.GetWidth() || !image.GetHeight()) return sf::Color(255,255,255);
+
+		int32 ix = std::min(std::max((int32)std::floor(x),0),(int32)image.GetWidth()-1);
+		int32 iy = std::min(std::max((int32)std::floor(y),0),(int32)image.GetHeight()-1);
+		return image.GetPixel(ix,iy);
+	}
+
+	SoftwareBackend::SoftwareBackend( uint32 width, uint32 height ) : m_width(0), m_height(0),
+		m_clipping(false), m_clipLeft(0), m_clipTop(0), m_clipRight(0), m_clipBottom(0)
+	{
+		Resize(width,height);
+	}
+
+	void SoftwareBackend::Resize( uint32 width, uint32 height )
+	{
+		m_width = width;
+		m_height = height;
+		m_pixels.assign(width*height*4,0);
+		m_view = sf::FloatRect(0.f,0.f,(float)width,(float)height);
+		m_clipping = false;
+		Clear();
+	}
+
+	void SoftwareBackend::Clear( const sf::Color& color /*= sf::Color(0,0,0)*/ )
+	{
+		for(uint32 i=0; i<m_pixels.size(); i+=4) {
+			m_pixels[i] = color.r;
+			m_pixels[i+1] = color.g;
+			m_pixels[i+2] = color.b;
+			m_pixels[i+3] = color.a;
+		}
+	}
+
+	void SoftwareBackend::SetView( const sf::FloatRect& view )
+	{
+		m_view = view;
+	}
+
+	const sf::FloatRect& SoftwareBackend::GetView() const
+	{
+		return m_view;
+	}
+
+	sf::Color SoftwareBackend::GetPixel( uint32 x, uint32 y ) const
+	{
+		if(x >= m_width || y >= m_height) return sf::Color(0,0,0,0);
+
+		const uint8* p = &m_pixels[(y*m_width+x)*4];
+		return sf::Color(p[0],p[1],p[2],p[3]);
+	}
+
+	const uint8* SoftwareBackend::GetPixels() const
+	{
+		return m_pixels.empty() ? NULL : &m_pixels[0];
+	}
+
+	gui::uint32 SoftwareBackend::GetChecksum() const
+	{
+		//FNV-1a
+		uint32 hash = 2166136261u;
+		for(uint32 i=0; i<m_pixels.size(); i++) {
+			hash ^= m_pixels[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	gui::uint32 SoftwareBackend::GetWidth() const
+	{
+		return m_width;
+	}
+
+	gui::uint32 SoftwareBackend::GetHeight() const
+	{
+		return m_height;
+	}
+
+	void SoftwareBackend::SetScissor( const Rect* scissor )
+	{
+		m_clipping = (scissor != NULL);
+		if(!scissor) return;
+
+		//glScissor counts the rows from the bottom
+		m_clipLeft = scissor->x;
+		m_clipRight = scissor->x + scissor->w;
+		m_clipTop = (int32)m_height - (scissor->y + scissor->h);
+		m_clipBottom = (int32)m_height - scissor->y;
+	}
+
+	void SoftwareBackend::DrawQuads( const ColorVertex* vertices, uint32 count )
+	{
+		Vertex quad[4];
+		for(uint32 i=0; i+3<count; i+=4) {
+			for(uint32 j=0; j<4; j++) {
+				quad[j] = ToPixels(sf::Vector2f(vertices[i+j].x,vertices[i+j].y),vertices[i+j].color);
+			}
+			DrawQuad(quad,NULL);
+		}
+	}
+
+	void SoftwareBackend::Draw( const sf::Drawable& drawable )
+	{
+		if(const sf::Shape* shape = dynamic_cast<const sf::Shape*>(&drawable)) {
+			DrawShape(*shape);
+		} else if(const sf::Sprite* sprite = dynamic_cast<const sf::Sprite*>(&drawable)) {
+			DrawSprite(*sprite);
+		} else if(const sf::String* string = dynamic_cast<const sf::String*>(&drawable)) {
+			TextMesh mesh;
+			mesh.Append(*string);
+			DrawMesh(mesh);
+		} else if(const TextMesh* mesh = dynamic_cast<const TextMesh*>(&drawable)) {
+			DrawMesh(*mesh);
+		}
+	}
+
+	SoftwareBackend::Vertex SoftwareBackend::ToPixels( const sf::Vector2f& point, const sf::Color& color ) const
+	{
+		Vertex v;
+		v.x = (point.x - m_view.Left) * m_width / m_view.GetWidth();
+		v.y = (point.y - m_view.Top) * m_height / m_view.GetHeight();
+		v.u = v.v = 0.f;
+		v.color = color;
+		return v;
+	}
+
+	void SoftwareBackend::DrawShape( const sf::Shape& shape )
+	{
+		uint32 count = shape.GetNbPoints();
+		if(count < 3) return;
+
+		std::vector<Vertex> points(count);
+		for(uint32 i=0; i<count; i++) {
+			points[i] = ToPixels(shape.TransformToGlobal(shape.GetPointPosition(i)),
+				shape.GetPointColor(i)*shape.GetColor());
+		}
+
+		//the fill, a convex polygon is a fan of triangles
+		for(uint32 i=1; i+1<count; i++) {
+			FillTriangle(points[0],points[i],points[i+1],NULL,i > 1);
+		}
+
+		//the outline, one quad along every edge
+		float width = shape.GetOutlineWidth();
+		if(width <= 0.f) return;
+
+		for(uint32 i=0; i<count; i++) {
+			uint32 next = (i+1) % count;
+			sf::Vector2f p0 = shape.TransformToGlobal(shape.GetPointPosition(i));
+			sf::Vector2f p1 = shape.TransformToGlobal(shape.GetPointPosition(next));
+
+			sf::Vector2f dir = p1 - p0;
+			float length = std::sqrt(dir.x*dir.x + dir.y*dir.y);
+			if(length <= 0.f) continue;
+
+			sf::Vector2f normal(-dir.y / length * width / 2, dir.x / length * width / 2);
+			sf::Color c0 = shape.GetPointOutlineColor(i)*shape.GetColor();
+			sf::Color c1 = shape.GetPointOutlineColor(next)*shape.GetColor();
+
+			Vertex quad[4];
+			quad[0] = ToPixels(p0 + normal,c0);
+			quad[1] = ToPixels(p1 + normal,c1);
+			quad[2] = ToPixels(p1 - normal,c1);
+			quad[3] = ToPixels(p0 - normal,c0);
+			DrawQuad(quad,NULL);
+		}
+	}
+
+	void SoftwareBackend::DrawSprite( const sf::Sprite& sprite )
+	{
+		const sf::IntRect& rect = sprite.GetSubRect();
+		float w = (float)rect.GetWidth(), h = (float)rect.GetHeight();
+
+		Vertex quad[4];
+		quad[0] = ToPixels(sprite.TransformToGlobal(sf::Vector2f(0.f,0.f)),sprite.GetColor());
+		quad[1] = ToPixels(sprite.TransformToGlobal(sf::Vector2f(w,0.f)),sprite.GetColor());
+		quad[2] = ToPixels(sprite.TransformToGlobal(sf::Vector2f(w,h)),sprite.GetColor());
+		quad[3] = ToPixels(sprite.TransformToGlobal(sf::Vector2f(0.f,h)),sprite.GetColor());
+
+		//no image is drawn as a plain quad, like SFML does
+		const sf::Image* image = sprite.GetImage();
+		if(!image) {
+			DrawQuad(quad,NULL);
+			return;
+		}
+
+		quad[0].u = quad[3].u = (float)rect.Left;
+		quad[1].u = quad[2].u = (float)rect.Right;
+		quad[0].v = quad[1].v = (float)rect.Top;
+		quad[2].v = quad[3].v = (float)rect.Bottom;
+
+		Texture texture(*image);
+
+		//the sub rect is in pixels already
+		texture.scaleX = texture.scaleY = 1.f;
+		DrawQuad(quad,&texture);
+	}
+
+	void SoftwareBackend::DrawMesh( const TextMesh& mesh )
+	{
+		Vertex quad[4];
+		for(uint32 i=0; i<mesh.m_runs.size(); i++) {
+			const TextMesh::Run& run = mesh.m_runs[i];
+
+			if(run.texture) {
+				Texture texture(*run.texture);
+				for(uint32 j=0; j+3<run.glyphs.size(); j+=4) {
+					for(uint32 k=0; k<4; k++) {
+						const TextMesh::Vertex& source = run.glyphs[j+k];
+						quad[k] = ToPixels(sf::Vector2f(source.x,source.y),source.color);
+						quad[k].u = source.u;
+						quad[k].v = source.v;
+					}
+					DrawQuad(quad,&texture);
+				}
+			}
+			for(uint32 j=0; j+3<run.lines.size(); j+=4) {
+				for(uint32 k=0; k<4; k++) {
+					const TextMesh::Vertex& source = run.lines[j+k];
+					quad[k] = ToPixels(sf::Vector2f(source.x,source.y),source.color);
+				}
+				DrawQuad(quad,NULL);
+			}
+		}
+	}
+
+	void SoftwareBackend::DrawQuad( const Vertex* quad, const Texture* texture )
+	{
+		//the pixels on the 0-2 diagonal only belong to the first half, so
+		//translucent quads don't get a visible seam
+		FillTriangle(quad[0],quad[1],quad[2],texture,false);
+		FillTriangle(quad[0],quad[2],quad[3],texture,true);
+	}
+
+	void SoftwareBackend::FillTriangle( const Vertex& a, const Vertex& b, const Vertex& c, 
+										const Texture* texture, bool sharedEdge )
+	{
+		float area = Edge(a.x,a.y,b.x,b.y,c.x,c.y);
+		if(area == 0.f) return;
+
+		int32 left = std::max((int32)std::floor(std::min(a.x,std::min(b.x,c.x))),0);
+		int32 right = std::min((int32)std::ceil(std::max(a.x,std::max(b.x,c.x))),(int32)m_width);
+		int32 top = std::max((int32)std::floor(std::min(a.y,std::min(b.y,c.y))),0);
+		int32 bottom = std::min((int32)std::ceil(std::max(a.y,std::max(b.y,c.y))),(int32)m_height);
+		if(m_clipping) {
+			left = std::max(left,m_clipLeft);
+			right = std::min(right,m_clipRight);
+			top = std::max(top,m_clipTop);
+			bottom = std::min(bottom,m_clipBottom);
+		}
+
+		for(int32 y=top; y<bottom; y++) {
+			for(int32 x=left; x<right; x++) {
+				//sampled at the pixel centers, the weights work for both windings
+				float px = x + 0.5f, py = y + 0.5f;
+				float wa = Edge(b.x,b.y,c.x,c.y,px,py) / area;
+				float wb = Edge(c.x,c.y,a.x,a.y,px,py) / area;
+				float wc = Edge(a.x,a.y,b.x,b.y,px,py) / area;
+				if(wa < 0.f || wb < 0.f || wc < 0.f) continue;
+
+				//on the a-b edge, drawn by the previous triangle
+				if(sharedEdge && wc == 0.f) continue;
+
+				sf::Color color(
+					uint8(wa*a.color.r + wb*b.color.r + wc*c.color.r),
+					uint8(wa*a.color.g + wb*b.color.g + wc*c.color.g),
+					uint8(wa*a.color.b + wb*b.color.b + wc*c.color.b),
+					uint8(wa*a.color.a + wb*b.color.a + wc*c.color.a));
+				if(texture) {
+					sf::Color texel = texture->Sample(
+						(wa*a.u + wb*b.u + wc*c.u) * texture->scaleX,
+						(wa*a.v + wb*b.v + wc*c.v) * texture->scaleY);
+					color = color * texel;
+				}
+				Blend(x,y,color);
+			}
+		}
+	}
+
+	void SoftwareBackend::Blend( uint32 x, uint32 y, const sf::Color& color )
+	{
+		//source over, like sf::Blend::Alpha
+		uint8* p = &m_pixels[(y*m_width+x)*4];
+		uint8 inverse = 255 - color.a;
+		p[0] = uint8(Modulate(color.r,color.a) + Modulate(p[0],inverse));
+		p[1] = uint8(Modulate(color.g,color.a) + Modulate(p[1],inverse));
+		p[2] = uint8(Modulate(color.b,color.a) + Modulate(p[2],inverse));
+		p[3] = uint8(color.a + Modulate(p[3],inverse));
+	}
+}
@@ -0,0 +1,177 @@
+#include "../include/gui/SpatialIndex.hpp"
+#include "../include/gui/Widget.hpp"
+#include <algorithm>
+
+namespace gui
+{
+	//widgets covering more cells than this are tested on every query
+	static const int32 MAX_CELLS = 256;
+
+	static bool FrontToBack(Widget* first, Widget* second)
+	{
+		return first->GetZOrder() > second->GetZOrder();
+	}
+
+	SpatialIndex::SpatialIndex( uint32 cellSize /*= 64*/ ) :
+		m_cellSize(cellSize ? cellSize : 64)
+	{
+
+	}
+
+	gui::uint32 SpatialIndex::CellKey( int32 cx, int32 cy )
+	{
+		return (uint32(cx & 0xFFFF) << 16) | uint32(cy & 0xFFFF);
+	}
+
+	gui::int32 SpatialIndex::CellCoord( int32 v ) const
+	{
+		//round towards -infinity so negative positions get their own cells
+		int32 size = (int32)m_cellSize;
+		return v >= 0 ? v / size : (v - size + 1) / size;
+	}
+
+	void SpatialIndex::Insert( Widget* widget )
+	{
+		if(!widget) return;
+
+		EntryList::iterator it = m_entries.find(widget);
+		if(it != m_entries.end()) {
+			Unlink(widget,it->second);
+			Link(widget,it->second);
+			return;
+		}
+		Link(widget,m_entries[widget]);
+	}
+
+	void SpatialIndex::Remove( Widget* widget )
+	{
+		EntryList::iterator it = m_entries.find(widget);
+		if(it == m_entries.end()) return;
+
+		Unlink(widget,it->second);
+		m_entries.erase(it);
+	}
+
+	void SpatialIndex::Update( Widget* widget )
+	{
+		EntryList::iterator it = m_entries.find(widget);
+		if(it == m_entries.end()) return;
+
+		Entry& entry = it->second;
+		Rect rect = widget->GetLocalRect();
+		if(entry.rect == rect) return;
+
+		//same cells, only the stored rect needs to change
+		if(!entry.large && CellCoord(rect.x) == entry.x0 && CellCoord(rect.y) == entry.y0 &&
+			CellCoord(rect.x+rect.w) == entry.x1 && CellCoord(rect.y+rect.h) == entry.y1)
+		{
+			entry.rect = rect;
+			return;
+		}
+		Unlink(widget,entry);
+		Link(widget,entry);
+	}
+
+	void SpatialIndex::Clear()
+	{
+		m_entries.clear();
+		m_cells.clear();
+		m_large.clear();
+	}
+
+	void SpatialIndex::Link( Widget* widget, Entry& entry )
+	{
+		Rect rect = widget->GetLocalRect();
+		entry.rect = rect;
+		entry.x0 = CellCoord(rect.x);
+		entry.y0 = CellCoord(rect.y);
+		entry.x1 = CellCoord(rect.x+rect.w);
+		entry.y1 = CellCoord(rect.y+rect.h);
+		entry.large = (entry.x1-entry.x0+1)*(entry.y1-entry.y0+1) > MAX_CELLS;
+
+		if(entry.large) {
+			m_large.push_back(widget);
+			return;
+		}
+		for(int32 cy = entry.y0; cy <= entry.y1; cy++) {
+			for(int32 cx = entry.x0; cx <= entry.x1; cx++) {
+				m_cells[CellKey(cx,cy)].push_back(widget);
+			}
+		}
+	}
+
+	void SpatialIndex::Unlink( Widget* widget, const Entry& entry )
+	{
+		if(entry.large) {
+			std::vector<Widget*>::iterator it = std::find(m_large.begin(),m_large.end(),widget);
+			if(it != m_large.end()) m_large.erase(it);
+			return;
+		}
+		for(int32 cy = entry.y0; cy <= entry.y1; cy++) {
+			for(int32 cx = entry.x0; cx <= entry.x1; cx++) {
+				CellList::iterator cell = m_cells.find(CellKey(cx,cy));
+				if(cell == m_cells.end()) continue;
+
+				std::vector<Widget*>& v = cell->second;
+				std::vector<Widget*>::iterator it = std::find(v.begin(),v.end(),widget);
+				if(it != v.end()) {
+					//order inside a cell doesn't matter, results get sorted
+					*it = v.back();
+					v.pop_back();
+				}
+				if(v.empty()) m_cells.erase(cell);
+			}
+		}
+	}
+
+	void SpatialIndex::QueryPoint( int x, int y, std::vector<Widget*>& result ) const
+	{
+		QueryRect(Rect(x,y,1,1),result);
+	}
+
+	void SpatialIndex::QueryRect( const Rect& rect, std::vector<Widget*>& result ) const
+	{
+		uint32 from = result.size();
+
+		int32 x0 = CellCoord(rect.x), y0 = CellCoord(rect.y);
+		int32 x1 = CellCoord(rect.x+rect.w), y1 = CellCoord(rect.y+rect.h);
+
+		for(int32 cy = y0; cy <= y1; cy++) {
+			for(int32 cx = x0; cx <= x1; cx++) {
+				CellList::const_iterator cell = m_cells.find(CellKey(cx,cy));
+				if(cell == m_cells.end()) continue;
+
+				const std::vector<Widget*>& v = cell->second;
+				for(uint32 i=0; i<v.size(); i++) {
+					EntryList::const_iterator e = m_entries.find(v[i]);
+					if(gui::IsCollision(e->second.rect,rect)) {
+						result.push_back(v[i]);
+					}
+				}
+			}
+		}
+		for(uint32 i=0; i<m_large.size(); i++) {
+			EntryList::const_iterator e = m_entries.find(m_large[i]);
+			if(gui::IsCollision(e->second.rect,rect)) {
+				result.push_back(m_large[i]);
+			}
+		}
+
+		//a widget spanning several of the queried cells is found more than once
+		if(x0 != x1 || y0 != y1) {
+			std::sort(result.begin()+from,result.end());
+			result.erase(std::unique(result.begin()+from,result.end()),result.end());
+		}
+		SortByFocus(result,from);
+	}
+
+	void SpatialIndex::SortByFocus( std::vector<Widget*>& result, uint32 from )
+	{
+		std::sort(result.begin()+from,result.end(),FrontToBack);
+	}
+
+	gui::uint32 SpatialIndex::GetSize() const
+	{
+		return m_entries.size();
+	}
+}
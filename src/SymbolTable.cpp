@@ -0,0 +1,56 @@
+#include "../include/gui/SymbolTable.hpp"
+#include "../include/gui/Debug.hpp"
+
+namespace gui
+{
+	SymbolTable::Table::Table()
+	{
+		//the fixed ids must match the enum
+		names.push_back("default");
+		names.push_back("");
+		index[names[Default]] = Default;
+		index[names[Empty]] = Empty;
+	}
+
+	SymbolTable::Table& SymbolTable::GetTable()
+	{
+		static Table table;
+		return table;
+	}
+
+	gui::uint32 SymbolTable::Intern( const std::string& name )
+	{
+		Table& table = GetTable();
+
+		SymbolIndex::const_iterator it = table.index.find(name);
+		if(it != table.index.end()) return it->second;
+
+		uint32 symbol = table.names.size();
+		table.names.push_back(name);
+		table.index[name] = symbol;
+		return symbol;
+	}
+
+	gui::uint32 SymbolTable::Find( const std::string& name )
+	{
+		const Table& table = GetTable();
+
+		SymbolIndex::const_iterator it = table.index.find(name);
+		return it != table.index.end() ? it->second : (uint32)Invalid;
+	}
+
+	const std::string& SymbolTable::GetName( uint32 symbol )
+	{
+		const Table& table = GetTable();
+		if(symbol >= table.names.size()) {
+			error_log("Unknown symbol %u!",symbol);
+			return table.names[Empty];
+		}
+		return table.names[symbol];
+	}
+
+	gui::uint32 SymbolTable::GetSize()
+	{
+		return GetTable().names.size();
+	}
+}
@@ -4,37 +4,174 @@
 #include <iostream>
 #include <vector>
 #include <stack>
+#include <algorithm>
+#include <cmath>
+
+//smooth scrolling covers half the remaining distance every this many ms
+static const float SCROLL_HALF_TIME = 40.f;
+
+//lines scrolled per mouse wheel step
+static const float WHEEL_LINES = 3.f;
 
 
 void gui::TextArea::SetText( const std::string& text )
 {
 	m_text = text;
-	std::stringstream s;
-	s.str(text);
-	Parse(s,m_lines,m_rect);
-	m_totalLines = m_lines.size();
-	m_viewableLines = m_totalLines;
-	SetPos(m_rect.x,m_rect.y,true);
+	Layout();
+
+	//new text starts at the top
+	m_scroll = m_targetScroll = 0.f;
+	UpdateVisibleLines();
+	MarkDirty();
+	Repaint();
 }
 
 void gui::TextArea::Draw() const
 {
 	Widget::Draw();
 
-	for(uint32 i=m_startingLine; i<m_lines.size(); i++) {
-		const Line& line = m_lines[i];
-		for(uint32 j=0; j<line.m_words.size(); j++) {
-			const Word& word = line.m_words[j];
-			for(uint32 k=0; k<word.m_char.size(); k++) {
-				const sf::String& string = word.m_char[k];
-				s_gui->GetWindow().Draw(string);
-			}
-		}
+	if(!m_mesh.IsEmpty()) {
+		//the lines at the edges stick out of the area
+		StartClipping();
+			s_gui->GetDrawList().Add(m_mesh);
+		StopClipping();
 	}
 }
 
-gui::TextArea::TextArea(): m_viewableLines(1),m_totalLines(1),
-						   m_startingLine(0)
+void gui::TextArea::Layout()
+{
+	//the lines are laid out relative to the text, scrolling and moving 
+	//only offset them
+	Rect container(0,0,m_rect.w,m_rect.h);
+	std::stringstream s;
+	s.str(m_text);
+	Parse(s,m_lines,container);
+	m_totalLines = m_lines.size();
+
+	m_lineTops.resize(m_lines.size()+1);
+	uint32 line_spacing = 0;
+	for(uint32 i=0; i<m_lines.size(); i++) {
+		m_lineTops[i] = line_spacing;
+		m_lines[i].SetPos(container,line_spacing);
+		line_spacing += m_lines[i].GetLineSpacing();
+	}
+	m_lineTops.back() = line_spacing;
+}
+
+void gui::TextArea::UpdateVisibleLines()
+{
+	if(m_lines.empty()) {
+		m_startingLine = m_viewableLines = 0;
+		RebuildMesh();
+		return;
+	}
+
+	//the last line starting at or above the top, up to the first one 
+	//starting below the bottom
+	uint32 top = (uint32)std::max(0.f,m_scroll);
+	uint32 bottom = (uint32)std::ceil(std::max(0.f,m_scroll)) + m_rect.h;
+	std::vector<uint32>::iterator lines_end = m_lineTops.end() - 1;
+
+	uint32 first = std::upper_bound(m_lineTops.begin(),lines_end,top) - m_lineTops.begin();
+	if(first > 0) --first;
+	uint32 last = std::lower_bound(m_lineTops.begin()+first,lines_end,bottom) - m_lineTops.begin();
+
+	m_startingLine = first;
+	m_viewableLines = std::max(last,first+1) - first;
+	RebuildMesh();
+}
+
+void gui::TextArea::RebuildMesh()
+{
+	//whole pixels keep the glyphs sharp while scrolling
+	sf::Vector2f offset((float)m_rect.x,(float)m_rect.y - std::floor(m_scroll + 0.5f));
+
+	m_mesh.Clear();
+	uint32 end = std::min(m_startingLine + m_viewableLines,(uint32)m_lines.size());
+	for(uint32 i=m_startingLine; i<end; i++) {
+		m_mesh.Append(m_lines[i].m_mesh,offset);
+	}
+}
+
+void gui::TextArea::Update( float diff )
+{
+	Widget::Update(diff);
+	if(m_scroll == m_targetScroll) return;
+
+	float left = m_targetScroll - m_scroll;
+	if(std::fabs(left) < 0.5f) {
+		m_scroll = m_targetScroll;
+	} else {
+		m_scroll += left * (1.f - std::pow(0.5f,diff / SCROLL_HALF_TIME));
+	}
+
+	UpdateVisibleLines();
+	Repaint();
+
+	//keep scrolling next frame
+	if(m_scroll != m_targetScroll) MarkDirty();
+}
+
+void gui::TextArea::OnOtherEvents( sf::Event* event )
+{
+	if(event->Type != sf::Event::MouseWheelMoved) return;
+
+	//until the lines are laid out there is no line to measure
+	float line_height = 14.f;
+	if(m_startingLine + 1 < m_lineTops.size()) {
+		line_height = (float)(m_lineTops[m_startingLine+1] - m_lineTops[m_startingLine]);
+	}
+	ScrollBy(-event->MouseWheel.Delta * WHEEL_LINES * line_height);
+}
+
+void gui::TextArea::ScrollTo( float offset, bool smooth /*= true*/ )
+{
+	float max = (float)GetTextHeight() - (float)m_rect.h;
+	offset = std::min(offset,max);
+	offset = std::max(offset,0.f);
+
+	m_targetScroll = offset;
+	if(!smooth) {
+		m_scroll = offset;
+		UpdateVisibleLines();
+		Repaint();
+	}
+	MarkDirty();
+}
+
+void gui::TextArea::ScrollBy( float delta, bool smooth /*= true*/ )
+{
+	ScrollTo(m_targetScroll + delta,smooth);
+}
+
+void gui::TextArea::ScrollToLine( uint32 line, bool smooth /*= true*/ )
+{
+	if(line >= m_lines.size()) return;
+	ScrollTo((float)m_lineTops[line],smooth);
+}
+
+float gui::TextArea::GetScroll() const
+{
+	return m_scroll;
+}
+
+gui::uint32 gui::TextArea::GetTextHeight() const
+{
+	return m_lineTops.empty() ? 0 : m_lineTops.back();
+}
+
+gui::uint32 gui::TextArea::GetFirstVisibleLine() const
+{
+	return m_startingLine;
+}
+
+gui::uint32 gui::TextArea::GetVisibleLineCount() const
+{
+	return m_viewableLines;
+}
+
+gui::TextArea::TextArea(): m_viewableLines(0),m_totalLines(1),
+						   m_startingLine(0),m_scroll(0.f),m_targetScroll(0.f)
 {
 
 	//buttons particular size hint
@@ -52,24 +189,19 @@ gui::TextArea::TextArea(): m_viewableLines(1),m_totalLines(1),
 void gui::TextArea::Resize( int w, int h , bool save /*=true*/)
 {
 	Widget::Resize(w,h,save);
-	std::stringstream s; 
-	s.str(m_text);
-	Parse(s,m_lines,m_rect);	//this will also set the pos of the text
-	SetPos(m_rect.x,m_rect.y,true);
+
+	//the width changes where the lines wrap
+	Layout();
+	ScrollTo(m_targetScroll,false);
 }
 
 void gui::TextArea::SetPos( int x, int y, bool forceMove, /* = false */
 							bool save /*=true*/)
 {
 	Widget::SetPos(x,y,forceMove,save);
-	uint32 line_spacing = 0;
-	for(uint32 i=0; i<m_lines.size(); i++) {
-		//find the spacing for the next line
-		if(i>0) {
-			line_spacing += m_lines[i-1].GetLineSpacing();
-		}
-		m_lines[i].SetPos(m_rect,line_spacing);
-	}
+
+	//the layout is relative to the text, only the offset changed
+	RebuildMesh();
 }
 
 void gui::TextArea::InitGraphics()
@@ -673,6 +805,14 @@ void gui::Line::SetPos( const Rect& container,uint32 line_spacing)
 		m_words[i].SetPos((int)temp.x,(int)temp.y);
 	}
 
+	//the strings only change here or when parsing, which ends up here too
+	m_mesh.Clear();
+	for(uint32 i=0; i<m_words.size(); i++) {
+		const Word& word = m_words[i];
+		for(uint32 j=0; j<word.m_char.size(); j++) {
+			m_mesh.Append(word.m_char[j]);
+		}
+	}
 }
 
 gui::uint32 gui::Line::GetLineSpacing() const
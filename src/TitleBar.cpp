@@ -49,6 +49,8 @@ namespace gui
 					{
 						gui::OnResize* r = static_cast<gui::OnResize*>(e);
 						Widget* widget = r->GetWidget();
+						if(!widget) break;
+
 						bool needToResize = true;
 						if(m_rect.w == widget->GetRect().w) 
 							needToResize = false;
@@ -64,7 +66,7 @@ namespace gui
 				case events::OnMove:
 					{
 						Widget* w = ((gui::OnResize*)e)->GetWidget();
-						SetPos(w->GetRect().x, w->GetRect().y,true);
+						if(w) SetPos(w->GetRect().x, w->GetRect().y,true);
 					} break;
 				default: break;
 			}
@@ -76,7 +78,7 @@ namespace gui
 		Widget::Draw();
 		if(!s_gui) return;
 			
-		s_gui->GetWindow().Draw(m_titleVisibleText);
+		s_gui->GetDrawList().Add(m_titleVisibleText);
 	}
 
 	void TitleBar::InitGraphics()
@@ -148,6 +150,8 @@ namespace gui
 		m_parent = parent;
 		m_mediator.ClearConnections();
 
+		//only the parent's latest rect matters
+		m_mediator.SetCoalescing(true);
 		m_mediator.Connect(parent,"default",events::OnResize,false);
 		m_mediator.Connect(parent,"default",events::OnMove,false);
 
@@ -158,6 +162,8 @@ namespace gui
 	{
 		m_titleText = title;
 		m_titleVisibleText.SetText(m_titleText);
+		MarkDirty();
+		Repaint();
 	}
 
 	void TitleBar::SetButtonStyle( ButtonStyle buttonStyle )
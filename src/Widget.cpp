@@ -9,18 +9,29 @@
 namespace gui {
 
 	GuiManager* Widget::s_gui = NULL;
-
-	Widget::Widget() : index(0), m_parent(0), m_focus(0),m_movable(true),
-					m_visible(true),m_mainVisible(true),m_clicked(false),
-					m_released(false), m_type(WIDGET), m_drag(false),
-					m_hotSpotX(0), m_hotSpotY(0), m_needUpdate(true),
-					m_resizable(true),m_isFocus(false),m_transparency(200),
-					m_individualTheme(false), m_hovering(false),
-					m_hoverTarget(NULL), m_solid(false), m_allowSave(true),
-					m_sprite(NULL),m_dropFlags(Drag::WidgetOnly),
-					m_dead(false),m_loading(false),m_doubleClickDiff(0),
-					m_doubleClickActivated(false), m_doubleClickTime(500)
-	{
+	uint32 Widget::s_nextId = 0;
+	uint32 Widget::s_transformStamp = 1;
+	std::vector<Widget*> Widget::s_eventPath;
+
+	Widget::Widget() : m_type(WIDGET), m_parent(0), m_focus(0),
+					m_hoverTarget(NULL), m_sprite(NULL),
+					m_nameSymbol(SymbolTable::Empty), m_needUpdate(true),
+					m_loading(false), m_isFocus(false), m_clicked(false),
+					m_released(false), m_worldStamp(1), m_parentStamp(0),
+					m_validStamp(0), m_applyingTransform(false),
+					m_resolvingCollisions(false), m_visible(true),
+					m_mainVisible(true), m_movable(true), m_solid(false),
+					m_resizable(true), m_hovering(false), m_allowSave(true),
+					m_transparency(200), m_individualTheme(false),
+					m_dropFlags(Drag::WidgetOnly), m_dead(false),
+					m_doubleClickDiff(0), m_doubleClickTime(500),
+					m_doubleClickActivated(false), m_drag(false),
+					m_hotSpotX(0), m_hotSpotY(0)
+	{
+		m_id = ++s_nextId;
+		m_handle = WidgetHandle::Acquire(this);
+		m_zNode.self = this;
+		m_mediator.SetOwner(this);
 		m_mediator.SetCurrentPath(m_name);
 
 		//set theme/default colors
@@ -38,16 +49,22 @@ namespace gui {
 		m_verticalPolicy	= Fixed;	
 	}
 
-	Widget::Widget( const std::string& name ): index(0), m_parent(0), 
-		m_focus(0),m_movable(true),m_visible(true),m_mainVisible(true),
-		m_clicked(false),m_released(false), m_type(WIDGET), m_drag(false),
-		m_hotSpotX(0), m_hotSpotY(0), m_needUpdate(true),m_resizable(true),
-		m_isFocus(true),m_transparency(200), m_individualTheme(false),
-		m_hovering(true),m_hoverTarget(NULL), m_solid(false), 
-		m_allowSave(true), m_sprite(NULL),m_dropFlags(Drag::WidgetOnly),
-		m_dead(false),m_loading(false),m_doubleClickDiff(0),
-		m_doubleClickActivated(false), m_doubleClickTime(500)
-	{
+	Widget::Widget( const std::string& name ): m_type(WIDGET), 
+		m_parent(0), m_focus(0), m_hoverTarget(NULL), m_sprite(NULL),
+		m_nameSymbol(SymbolTable::Empty), m_needUpdate(true), m_loading(false),
+		m_isFocus(true), m_clicked(false), m_released(false), m_worldStamp(1),
+		m_parentStamp(0), m_validStamp(0), m_applyingTransform(false),
+		m_resolvingCollisions(false), m_visible(true), m_mainVisible(true),
+		m_movable(true), m_solid(false), m_resizable(true), m_hovering(true),
+		m_allowSave(true), m_transparency(200), m_individualTheme(false),
+		m_dropFlags(Drag::WidgetOnly), m_dead(false), m_doubleClickDiff(0),
+		m_doubleClickTime(500), m_doubleClickActivated(false), m_drag(false),
+		m_hotSpotX(0), m_hotSpotY(0)
+	{
+		m_id = ++s_nextId;
+		m_handle = WidgetHandle::Acquire(this);
+		m_zNode.self = this;
+		m_mediator.SetOwner(this);
 		SetName(name);
 		m_mediator.SetCurrentPath(name);
 
@@ -66,14 +83,22 @@ namespace gui {
 	}
 	Widget::~Widget()
 	{
-		for(WidgetList::iterator it = m_widgets.begin(); 
-			it!= m_widgets.end();it++) 
-		{
-			delete it->second;
+		//the handles to this widget resolve to NULL from now on
+		WidgetHandle::Release(m_handle);
+
+		while(!m_widgets.empty()) {
+			Widget* child = m_widgets.top();
+			m_widgets.remove(child);
+			delete child;
 		}
-		m_widgets.clear();
+		m_nameIndex.clear();
+		m_shadowedNames.clear();
+		m_spatialIndex.Clear();
 		m_mediator.ClearConnections();
 		m_mediator.ConsumeEvents();
+
+		//the address may get reused by another widget
+		WidgetPath::Invalidate();
 	}
 
 	void Widget::SetMovable( bool flag )
@@ -83,6 +108,8 @@ namespace gui {
 
 	void Widget::Show()
 	{
+		MarkDirty();
+		Repaint();
 		OnShow();
 		m_settings.SetStringValue("visibility", "on");
 		m_visible = true; 
@@ -91,6 +118,8 @@ namespace gui {
 
 	void Widget::Hide()
 	{
+		MarkDirty();
+		Repaint();
 		OnHide();
 		m_settings.SetStringValue("visibility", "off");
 		m_visible = false; 
@@ -110,7 +139,7 @@ namespace gui {
 		else SetPos(m_parent->GetRect().x+x,m_parent->GetRect().y+y);
 	}
 
-	Widget::WidgetList& Widget::GetWidgetList() const
+	WidgetList& Widget::GetWidgetList() const
 	{
 		return m_widgets;
 	}
@@ -143,12 +172,14 @@ namespace gui {
 
 	void Widget::SetParent( Widget* parent )
 	{
+		//keep the world position, the local one is relative to the old parent
+		Rect world = GetRect();
 		m_parent = parent;
 
 		m_mediator.SetCurrentPath(GetWidgetPath());
 
 		//error checking for positioning since you now got a new parent
-		SetPos(m_rect.x, m_rect.y,true);
+		SetPos(world.x, world.y,true);
 	}
 
 	Widget* Widget::GetParent() const
@@ -158,6 +189,8 @@ namespace gui {
 
 	void Widget::SetBackgroundColor( sf::Color color )
 	{
+		MarkDirty();
+		Repaint();
 		m_shape.SetColor(color);
 		m_settings.SetUint32Value("background-color",ColorToUnsigned(color));
 		m_individualTheme = true;
@@ -166,6 +199,7 @@ namespace gui {
 	void Widget::Resize( int w, int h , bool save /*=true*/)
 	{
 		Rect temp = m_rect;
+		Repaint(temp);
 		m_rect.w = w; 
 		m_rect.h = h; 
 
@@ -181,6 +215,9 @@ namespace gui {
 			m_settings.SetUint32Value("width", m_rect.w);
 			m_settings.SetUint32Value("height", m_rect.h);
 		}
+		UpdateSpatialIndex();
+		MarkDirty();
+		Repaint();
 		OnResize(m_rect);
 		InitGraphics();
 		UpdateClipArea();
@@ -191,18 +228,31 @@ namespace gui {
 	{
 		if(!m_movable && !forceMove) return;
 
-		m_needUpdate = true;
+		//the old rect is out of date if a parent moved in the meantime
+		if(!m_applyingTransform) ValidateTransform();
 
 		Rect temp = m_rect;
 		m_rect.x = x; 
 		m_rect.y = y;
 
+		//following the parent, the local position stays the same
+		if(m_applyingTransform) {
+			if(!m_sprite)
+				m_shape.SetPosition(m_rect.GetPos());
+			else m_sprite->SetPosition(m_rect.GetPos());
+
+			if(temp.x != m_rect.x || temp.y != m_rect.y) ++m_worldStamp;
+			UpdateClipArea();
+			return;
+		}
+
+		MarkDirty();
+
 		//error checking to keep widgets in place, to allow outside 
 		//of parents rect, modify the drag flags to anywhere?
 		if(m_parent && m_dropFlags == Drag::WidgetOnly ) 
 		{
 			const Rect& prect = m_parent->GetRect();
-			const WidgetList& widgets = m_parent->GetWidgetList();
 
 			//don't allowed then leave the parent's rect
 			if(m_rect.x < prect.x)
@@ -224,15 +274,30 @@ namespace gui {
 				m_rect.y = prect.y + prect.h - m_rect.h;
 			}	
 		}
-		//also move child widgets
-		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			Widget* widget = it->second;
-			Rect childRect = widget->GetRect();
-			int xpos = m_rect.x - temp.x + childRect.x;
-			int ypos = m_rect.y - temp.y + childRect.y ;
-			widget->SetPos(xpos,ypos,true); //force child widgets to move!
+
+		//only the offset to the parent is kept, the child widgets
+		//don't get moved here, they follow when their rect is read
+		if(m_parent) {
+			const Rect& prect = m_parent->GetRect();
+			m_localPos.x = m_rect.x - prect.x;
+			m_localPos.y = m_rect.y - prect.y;
+			m_parentStamp = m_parent->m_worldStamp;
+		} else {
+			m_localPos.x = m_rect.x;
+			m_localPos.y = m_rect.y;
+		}
+		m_validStamp = s_transformStamp;
+
+		bool moved = (temp.x != m_rect.x || temp.y != m_rect.y);
+		if(moved) {
+			++m_worldStamp;
+			++s_transformStamp;
+			m_validStamp = s_transformStamp;
+
+			//the children follow, so the old and new rects cover them too
+			Repaint(temp);
+			Repaint();
 		}
-		ResolveChildCollisions();	//this is slightly broken!
 
 		if(save) {
 			m_settings.SetInt32Value("posx",m_rect.x);
@@ -243,7 +308,12 @@ namespace gui {
 			m_shape.SetPosition(m_rect.GetPos());
 		else m_sprite->SetPosition(m_rect.GetPos());
 
-		OnMove(temp);
+		UpdateSpatialIndex();
+
+		//only the pairs involving this widget can have changed
+		if(moved && m_parent) m_parent->ResolveChildCollisions(this);
+
+		if(moved) OnMove(temp);
 		UpdateClipArea();
 	}
 
@@ -255,14 +325,49 @@ namespace gui {
 
 	const Rect& Widget::GetRect() const
 	{
+		ValidateTransform();
 		return m_rect;
 	}
 
 	sf::Vector2f Widget::GetPos() const
 	{
+		ValidateTransform();
 		return sf::Vector2f((float)m_rect.x,(float)m_rect.y);
 	}
 
+	gui::Rect Widget::GetLocalRect() const
+	{
+		return Rect(m_localPos.x,m_localPos.y,m_rect.w,m_rect.h);
+	}
+
+	const sf::Vector2i& Widget::GetLocalPos() const
+	{
+		return m_localPos;
+	}
+
+	void Widget::ValidateTransform() const
+	{
+		//nothing moved since this widget was last validated
+		if(!m_parent || m_validStamp == s_transformStamp) return;
+
+		m_parent->ValidateTransform();
+		if(m_parentStamp != m_parent->m_worldStamp) {
+			m_parentStamp = m_parent->m_worldStamp;
+			const_cast<Widget*>(this)->ApplyTransform();
+		}
+		m_validStamp = s_transformStamp;
+	}
+
+	void Widget::ApplyTransform()
+	{
+		//the parent is already valid, so only this widget is updated
+		const Rect& prect = m_parent->m_rect;
+
+		m_applyingTransform = true;
+		SetPos(prect.x+m_localPos.x, prect.y+m_localPos.y, true, false);
+		m_applyingTransform = false;
+	}
+
 	bool Widget::AddWidget( Widget* child )
 	{
 		if(!child) return false;
@@ -271,52 +376,124 @@ namespace gui {
 			return false;
 		}
 
-		child->SetParent(this);
-		child->SetId(++index);
+		//a widget can only be managed by one container at a time
+		if(child->m_parent && child->m_parent != this) {
+			child->m_parent->RemoveWidget(child);
+		} else if(!child->m_parent && s_gui) {
+			s_gui->RemoveWidget(child);
+		}
 
-		m_widgets[index] = child;
+		child->SetParent(this);
+		m_widgets.push_back(child);
+		child->MarkDirty();
+		child->Repaint();
+		m_nameIndex[child->GetNameSymbol()] = child;
+		m_spatialIndex.Insert(child);
+		WidgetPath::Invalidate();
 		return true;
 	}
 
 	void Widget::DeleteWidget( const std::string& widgetName )
 	{
-		//O(n) search complexity
 		if(Widget* child = FindChildByName(widgetName)) {
-			//another O(log(n)) search complexity.. need to improve
-			WidgetList::iterator it = m_widgets.find(child->GetId());
-
-			if(it != m_widgets.end()) {
-				m_freeWidgets.push_back(child);
-			}
+			m_freeWidgets.push_back(child);
 		}
 	}
 
-	//might remove another widget if passed a widget from another parent
-	//which happens to have a id that matches one from the current widget
 	bool Widget::RemoveWidget( Widget* widget )
 	{
 		if(!widget) return false;
 
-		WidgetList::iterator it = m_widgets.find(widget->GetId());
-		if(it == m_widgets.end()) {
+		if(!m_widgets.contains(widget)) {
 			debug_log("Widget \"%s\" doesn't have a child called \"%s\"", 
 						m_name.c_str(),widget->GetName().c_str());		
 			return false;
 		}
-		m_widgets.erase(it);
+		m_widgets.remove(widget);
+		widget->Repaint();
+
+		//focus and hover only ever point at direct children
+		if(m_focus == widget) m_focus = NULL;
+		if(m_hoverTarget == widget) m_hoverTarget = NULL;
+
+		UnindexName(widget,widget->GetNameSymbol());
+		m_spatialIndex.Remove(widget);
+		WidgetPath::Invalidate();
 		return true;
 	}
 
 	Widget* Widget::FindChildByName( const std::string& name ) const
 	{
-		for(WidgetList::const_iterator it = m_widgets.begin(); 
-			it != m_widgets.end(); it++) 
-		{
-			if(it->second->GetName() == name) {
-				return it->second;
+		//a name that was never interned can't belong to any widget
+		uint32 symbol = SymbolTable::Find(name);
+		if(symbol == SymbolTable::Invalid) return NULL;
+
+		return FindChildBySymbol(symbol);
+	}
+
+	Widget* Widget::FindChildBySymbol( uint32 nameSymbol ) const
+	{
+		NameIndex::const_iterator it = m_nameIndex.find(nameSymbol);
+		if(it == m_nameIndex.end()) {
+			return NULL;
+		}
+		return it->second;
+	}
+
+	void Widget::UpdateNameIndex( Widget* child, uint32 oldName )
+	{
+		//only children are indexed
+		if(!child || child->GetParent() != this) return;
+		if(oldName == child->GetNameSymbol()) return;
+
+		UnindexName(child,oldName);
+
+		//don't overwrite a sibling that already uses the name, it's found
+		//first until it goes away(see UnindexName)
+		Widget* sibling = FindChildBySymbol(child->GetNameSymbol());
+		if(!sibling) {
+			m_nameIndex[child->GetNameSymbol()] = child;
+		} else if(sibling != child) {
+			debug_log("Widget \"%s\" already has a child called \"%s\"", 
+						m_name.c_str(),child->GetName().c_str());
+			m_shadowedNames[child->GetNameSymbol()]++;
+		}
+		WidgetPath::Invalidate();
+	}
+
+	void Widget::UnindexName( Widget* child, uint32 nameSymbol )
+	{
+		NameIndex::iterator it = m_nameIndex.find(nameSymbol);
+		if(it == m_nameIndex.end()) return;
+
+		NameCount::iterator shadowed = m_shadowedNames.find(nameSymbol);
+		if(it->second != child) {
+			//the child was one of the siblings left out of the index
+			if(shadowed != m_shadowedNames.end() && !--shadowed->second) {
+				m_shadowedNames.erase(shadowed);
 			}
+			return;
+		}
+		m_nameIndex.erase(it);
+
+		//only a name another sibling uses too is searched for
+		if(shadowed == m_shadowedNames.end()) return;
+		for(WidgetList::iterator i = m_widgets.begin(); i != m_widgets.end(); i++) {
+			if((*i) != child && (*i)->GetNameSymbol() == nameSymbol) {
+				m_nameIndex[nameSymbol] = (*i);
+				break;
+			}
+		}
+		if(!--shadowed->second) m_shadowedNames.erase(shadowed);
+	}
+
+	void Widget::UpdateSpatialIndex()
+	{
+		if(m_parent) {
+			m_parent->m_spatialIndex.Update(this);
+		} else if(s_gui) {
+			s_gui->m_spatialIndex.Update(this);
 		}
-		return NULL;
 	}
 
 	gui::uint32 Widget::GetId() const
@@ -329,29 +506,39 @@ namespace gui {
 		m_id = id;
 	}
 
+	const WidgetHandle& Widget::GetHandle() const
+	{
+		return m_handle;
+	}
+
+	gui::uint32 Widget::GetZOrder() const
+	{
+		return m_zNode.zOrder;
+	}
+
 	void Widget::OnClickPressed( sf::Event* event )
 	{
 		SetClicked(true); 
 		//std::cout << GetName() << ": Click Pressed" << std::endl;
-		m_mediator.PostEvent(new gui::OnClickPressed(this));
+		m_mediator.PostEvent<gui::OnClickPressed>(this);
 	}
 
 	void Widget::OnClickReleased( sf::Event* event )
 	{
 		SetClicked(false); 
 		//std::cout << GetName() << ": Click Released" << std::endl;
-		m_mediator.PostEvent(new gui::OnClickReleased(this));
+		m_mediator.PostEvent<gui::OnClickReleased>(this);
 	}
 
 	void Widget::OnKeyPressed( sf::Event* event )
 	{
-		m_mediator.PostEvent(new gui::OnKeyPressed(this,event->Key));
+		m_mediator.PostEvent<gui::OnKeyPressed>(this,event->Key);
 		//std::cout << GetName() << ": Key Pressed" << std::endl;
 	}
 
 	void Widget::OnKeyReleased( sf::Event* event )
 	{
-		m_mediator.PostEvent(new gui::OnKeyReleased(this,event->Key));
+		m_mediator.PostEvent<gui::OnKeyReleased>(this,event->Key);
 		//std::cout << GetName() << ": Key Released" << std::endl;
 	}
 
@@ -367,8 +554,17 @@ namespace gui {
 
 	void Widget::SetName( const std::string& newName )
 	{
+		uint32 oldName = m_nameSymbol;
 		m_name = newName;
+		m_nameSymbol = SymbolTable::Intern(newName);
 		m_mediator.SetCurrentPath(GetWidgetPath());
+
+		//whoever manages this widget must re-index it under the new name
+		if(m_parent) {
+			m_parent->UpdateNameIndex(this,oldName);
+		} else if(s_gui) {
+			s_gui->UpdateNameIndex(this,oldName);
+		}
 	}
 
 	const std::string& Widget::GetName() const
@@ -376,6 +572,11 @@ namespace gui {
 		return m_name;
 	}
 
+	gui::uint32 Widget::GetNameSymbol() const
+	{
+		return m_nameSymbol;
+	}
+
 	void Widget::Update( float diff )
 	{
 		if(m_dead) return;
@@ -388,15 +589,24 @@ namespace gui {
 
 		if(m_doubleClickActivated) {
 			m_doubleClickDiff -= diff;
+
+			//keep the timer running until the double click expires
+			if(m_doubleClickDiff >= 0) MarkDirty();
 		}
 
 		//handle the events..also takes care of child widget events
 		_HandleEvents();
 
 		for(WidgetList::iterator it=m_widgets.begin(); it!=m_widgets.end();it++) {
-			if(it->second->m_dead) {
-				m_freeWidgets.push_back(it->second);
-			} else it->second->Update(diff);
+			Widget* child = (*it);
+			if(child->m_dead) {
+				m_freeWidgets.push_back(child);
+			} else if(child->m_needUpdate) {
+				//clean subtrees don't need to be visited
+				child->m_needUpdate = false;
+				child->ValidateTransform();
+				child->Update(diff);
+			}
 		}
 		
 		FreeDeadWidgets();
@@ -466,31 +676,35 @@ namespace gui {
 		if(!m_visible)
 			return;
 
-		s_gui->GetWindow().Draw(m_shape);
+		s_gui->GetDrawList().Add(m_shape);
 
 		//also draw children if any
+		DrawChildren();
+	}
+
+	void Widget::DrawChildren() const
+	{
+		//whatever isn't visible of this widget hides the children too
+		Rect clip = GetIntersection(m_visibleRect,GetChildClipRect());
+		if(!clip.w) return;
+
 		for(WidgetList::const_iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
+			//children of a moved parent only get repositioned when drawn
+			(*it)->ValidateTransform();
+
+			//clipped away by the parents, the view or the damage being drawn
+			if(!(*it)->UpdateVisibleRect(clip)) continue;
+
+			//behind the opaque widgets in front of the top-level widget
+			if(s_gui && s_gui->IsOccluded((*it)->m_visibleRect)) continue;
+
 			//don't draw outside parent's rect
 			StartClipping();
-				it->second->Draw();
+				(*it)->Draw();
 			StopClipping();
 		}
 	}
 
-
-	//deprecated?
-	void Widget::Draw( const sf::Image* image )
-	{
-		if(!image) return;
-		
-		sf::Sprite sprite;
-		sprite.SetImage(*image);
-		sprite.SetPosition(GetPos());
-		sprite.Resize(GetSize());
-		sprite.SetColor(sf::Color(255,255,255,m_transparency));
-		s_gui->GetWindow().Draw(sprite);
-
-	}
 	sf::Vector2f Widget::GetSize() const
 	{
 		return sf::Vector2f((float)m_rect.w,(float)m_rect.h);
@@ -507,8 +721,8 @@ namespace gui {
 		OnHide();
 
 		//make your children post the same event, since they're invisble too now
-		for(uint32 i=0; i<m_widgets.size(); i++) {
-			m_widgets[i]->HideChildren();
+		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
+			(*it)->HideChildren();
 		}
 	}
 
@@ -516,18 +730,48 @@ namespace gui {
 	{
 		OnShow();
 
-		for(uint32 i=0; i<m_widgets.size(); i++) {
-			m_widgets[i]->ShowChildren();
+		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
+			(*it)->ShowChildren();
 		}
 	}
 
 	void Widget::RegisterEvent( sf::Event* event )
 	{
 		m_events.push_back(event);
+		MarkDirty();
+	}
+
+	void Widget::MarkDirty()
+	{
+		m_needUpdate = true;
+
+		//stop at the first dirty parent, the ones above it are dirty already
+		for(Widget* parent = m_parent; parent && !parent->m_needUpdate; parent = parent->m_parent) {
+			parent->m_needUpdate = true;
+		}
+	}
+
+	bool Widget::NeedsUpdate() const
+	{
+		return m_needUpdate;
+	}
+
+	void Widget::Repaint()
+	{
+		Repaint(GetRect());
+	}
+
+	void Widget::Repaint( const Rect& rect )
+	{
+		if(s_gui) s_gui->AddDamage(rect);
 	}
 
 	void Widget::_DispatchEvent( sf::Event* event )
 	{
+		if(s_gui) s_gui->RecordLatency(LatencyStats::Dispatch,event->Type,s_gui->GetRoutedTimestamp());
+
+		//clicks, keys and text change how the target looks, moves alone don't
+		if(event->Type != sf::Event::MouseMoved) Repaint();
 		OnEvent(event);
 	}
 	
@@ -562,12 +806,8 @@ namespace gui {
 	{
 		if(!m_movable) return false;
 
-		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			if(it->second->IsCollision(Rect(x,y,1,1))) {
-				return false;
-			}
-		}
-		return true;
+		//can't drag if the click landed on a child
+		return GetWidgetAt(x,y) == NULL;
 	}
 
 	gui::uint8 Widget::GetTransparency() const
@@ -577,169 +817,222 @@ namespace gui {
 
 	void Widget::SetTransparency( uint8 val )
 	{
+		MarkDirty();
+		Repaint();
 		m_transparency = val;
 		m_settings.SetUint32Value("alpha", (uint32)val);
 	}
 
 	void Widget::_HandleEvents()
 	{
-		//if the widget has child widgets
-		if(m_widgets.size() > 0) {
-			for(int i=0; i<(int)m_events.size(); i++) {
-				sf::Event* event = m_events[i];
-				switch(event->Type) {
-					case sf::Event::MouseButtonPressed:
-						{
-							WidgetList::reverse_iterator itr = m_widgets.rbegin();
-							for(; itr!=m_widgets.rend(); itr++) {
-								//you don't get events if dead or hidden
-								if(itr->second->m_dead || itr->second->IsHidden()) 
-									continue;
-								//you don't get events if hidden behind the parent's clip rect
-								if(!itr->second->IsCollision(NormalizeClipAreaView())) 
-									continue;
-
-								int x = m_events[i]->MouseButton.X;
-								int y = m_events[i]->MouseButton.Y;
-								sf::Vector2f v = s_gui->GetWindow().ConvertCoords(x,y);
-								x = (int)v.x; y = (int)v.y;
-								if(itr->second->IsCollision(Rect(x,y,2,2))) {
-									SetFocus(itr->second);						
-									int X = (int)m_focus->GetPos().x;
-									int Y = (int)m_focus->GetPos().y;
-
-									//_StartDrag(x-X,y-Y);
-									Drag* drag = itr->second->CreateDrag(event);
-									s_gui->RegisterDrag(drag);
-
-									//a child received the event.. so register it
-									itr->second->RegisterEvent(event);
-	
-									//another click happened.. is it within time?
-									if(m_doubleClickActivated) {
-										if(m_doubleClickDiff < 0) {
-											//it was not within time.. double click expired
-											m_doubleClickDiff = m_doubleClickTime;
-											m_doubleClickActivated = false;
-										} else {
-											itr->second->OnDoubleClick(event);
-											//reset double click
-											m_doubleClickActivated = false;
-											m_doubleClickDiff = m_doubleClickTime;
-										}
-									} else { //first click.. activate the double click
-										m_doubleClickActivated = true;
-										m_doubleClickDiff = m_doubleClickTime;
-									}
-									break;
-								} 
-							}
-							//if no collisions occurred then it's your event...
-							if(itr == m_widgets.rend()) {
-								//make current focus lose focus..
-								if(m_focus) {
-									m_focus->_LoseFocus();
-									m_focus = NULL;
-								}
-								_DispatchEvent(event); //so dispatch it!
-							}
-						}
-						break;
-					case sf::Event::MouseButtonReleased:
-						if(m_focus) { //if you have focus that means you have child widgets
-							sf::Vector2f v;
-							v.x = (float)m_events[i]->MouseButton.X;
-							v.y = (float)m_events[i]->MouseButton.Y;
-							v = s_gui->GetWindow().ConvertCoords((int)v.x,(int)v.y);
-
-							//focus will get the event even if it's not colliding!
-							m_focus->RegisterEvent(event);
-
-							//if you're not colliding though.. you will lose focus!
-							if(!m_focus->IsCollision(Rect((int)v.x,(int)v.y,1,1))) {
-								m_focus->_LoseFocus(false);
-								m_focus = NULL;
-							}
-
-							//stop drag
-							m_drag = false;
-						} else {
-							//if you are a leaf.. you own the event.. dispatch it!
-							if(m_widgets.empty()) {
-								_DispatchEvent(event);
-							} else {
-								sf::Vector2f a((float)event->MouseButton.X,
-									(float)event->MouseButton.Y);
-								ConvertCoords(a);
-							}
-						}
-						break;
-					case sf::Event::MouseMoved:
-						{
-							sf::Vector2f a((float)event->MouseMove.X,
-								(float)event->MouseMove.Y);
-							ConvertCoords(a);
-
-							if(m_drag && m_focus) {
-								m_focus->SetPos((int)a.x-m_hotSpotX, (int)a.y-m_hotSpotY);
-							}
-							Widget* temp = NULL;
-							bool hadHover = false;
-							WidgetList::reverse_iterator it;
-							for(it	= m_widgets.rbegin(); it != m_widgets.rend(); it++) {
-								if(it->second->IsCollision(Rect((int)a.x,(int)a.y,1,1))) {
-									if(!it->second->m_visible) continue;
-
-									//if it's the same widget.. don't count it
-									if(m_hoverTarget == it->second) {
-										if(m_hoverTarget) m_hoverTarget->RegisterEvent(event);
-										break;
-									}
-
-									it->second->OnHover();	
-
-									temp = m_hoverTarget;
-									m_hoverTarget = it->second;
-									m_hoverTarget->RegisterEvent(event);
-
-									break; //the mouse can only hover over 1 widget at a time..
-								}
-							}
-							if(temp) {
-								temp->OnHoverLost();
-							} else if(it == m_widgets.rend()) {
-								if(m_hoverTarget) m_hoverTarget->OnHoverLost();
-								m_hoverTarget = NULL;
-							}
-							OnEvent(event);
-
-						} break;
-					default:
-						OnEvent(event);
-
-						if(m_focus) {
-							m_focus->RegisterEvent(event);
-						}
-						break;
-				}
-			}
-		} else {	//else you are a leaf .. so you own the event!
-			for(uint32 i=0; i<m_events.size();i++) {
-				_DispatchEvent(m_events[i]);
-			}
+		//events registered from outside the routing(see RegisterEvent)
+		for(uint32 i=0; i<m_events.size(); i++) {
+			RouteEvent(m_events[i]);
 		}
 
 		//we solved events..so clear them
 		m_events.clear();
+	}
+
+	void Widget::RouteEvent( sf::Event* event )
+	{
+		sf::Vector2f pos;
+		if(event->Type == sf::Event::MouseButtonPressed || event->Type == sf::Event::MouseButtonReleased) {
+			pos = s_gui->GetWindow().ConvertCoords(event->MouseButton.X,event->MouseButton.Y);
+		} else if(event->Type == sf::Event::MouseMoved) {
+			pos = s_gui->GetWindow().ConvertCoords(event->MouseMove.X,event->MouseMove.Y);
+		}
+
+		//the whole path is found once, from this widget down to the target.
+		//The buffer is taken while routing, in case a handler routes too
+		std::vector<Widget*> path;
+		path.swap(s_eventPath);
+		path.clear();
+		GetEventPath(event,pos,path);
+
+		//capture phase, on the way down: a parent can keep the event
+		uint32 down = 0;
+		bool kept = false;
+		while(down+1 < path.size()) {
+			Widget* parent = path[down];
+			Widget* child = path[down+1];
+			parent->RouteDown(child,event);
+			++down;
+
+			//the handlers might have killed the child on the way
+			if(child->m_dead || parent->OnCaptureEvent(child,event)) {
+				kept = true;
+				break;
+			}
+		}
+
+		if(!kept) path[down]->RouteToTarget(event);
+
+		//bubble phase, on the way back up, but not to the parent that kept it
+		for(uint32 i=down; i>0; i--) {
+			if(!kept || i < down) path[i-1]->OnChildEvent(path[i],event);
+			path[i-1]->RouteUp(path[i],event,pos);
+		}
+		s_eventPath.swap(path);
+	}
+
+	void Widget::GetEventPath( sf::Event* event, const sf::Vector2f& pos, std::vector<Widget*>& path )
+	{
+		path.push_back(this);
+
+		Widget* current = this;
+		switch(event->Type) {
+			case sf::Event::MouseButtonPressed:
+			case sf::Event::MouseMoved:
+				{
+					//down the hit children, each one is validated before
+					//its own children are tested against it
+					std::vector<Widget*> candidates;
+					while((current = current->GetHitChild(pos,candidates))) {
+						current->ValidateTransform();
+						path.push_back(current);
+					}
+				}
+				break;
+			default:
+				//down the focused children, they get everything else
+				while(current->m_focus && !current->m_focus->m_dead) {
+					current = current->m_focus;
+					current->ValidateTransform();
+					path.push_back(current);
+				}
+				break;
+		}
+	}
+
+	Widget* Widget::GetHitChild( const sf::Vector2f& pos, std::vector<Widget*>& candidates ) const
+	{
+		int x = (int)pos.x;
+		int y = (int)pos.y;
+
+		//only the children under the cursor, front to back
+		candidates.clear();
+		const Rect& rect = GetRect();
+		m_spatialIndex.QueryPoint(x-rect.x,y-rect.y,candidates);
+
+		Rect clip = NormalizeClipAreaView();
+		for(uint32 c=0; c<candidates.size(); c++) {
+			Widget* child = candidates[c];
+			//you don't get events if dead or hidden
+			if(child->m_dead || child->IsHidden()) 
+				continue;
+			//you don't get events if hidden behind the parent's clip rect
+			if(!child->IsCollision(clip)) 
+				continue;
+
+			if(child->IsCollision(Rect(x,y,1,1))) return child;
+		}
+		return NULL;
+	}
+
+	void Widget::RouteDown( Widget* child, sf::Event* event )
+	{
+		//the widget has to run its update after handling the event
+		MarkDirty();
+
+		switch(event->Type) {
+			case sf::Event::MouseButtonPressed:
+				{
+					SetFocus(child);
+
+					Drag* drag = child->CreateDrag(event);
+					s_gui->RegisterDrag(drag);
+				}
+				break;
+			case sf::Event::MouseButtonReleased:
+				break;
+			case sf::Event::MouseMoved:
+				//if it's the same widget.. don't count it
+				if(m_hoverTarget != child) {
+					Widget* temp = m_hoverTarget;
+					child->OnHover();
+					m_hoverTarget = child;
+					if(temp) temp->OnHoverLost();
+				}
+				break;
+			default:
+				//the parents see the other events before their focus
+				OnEvent(event);
+				break;
+		}
+	}
+
+	void Widget::RouteToTarget( sf::Event* event )
+	{
+		MarkDirty();
+
+		switch(event->Type) {
+			case sf::Event::MouseButtonPressed:
+				//no child was clicked, make current focus lose focus
+				if(m_focus) {
+					m_focus->_LoseFocus();
+					m_focus = NULL;
+				}
+				break;
+			case sf::Event::MouseMoved:
+				//no child is hovered anymore
+				if(m_hoverTarget) {
+					m_hoverTarget->OnHoverLost();
+					m_hoverTarget = NULL;
+				}
+				break;
+			default:
+				break;
+		}
+		_DispatchEvent(event);
+	}
+
+	void Widget::RouteUp( Widget* child, sf::Event* event, const sf::Vector2f& pos )
+	{
+		switch(event->Type) {
+			case sf::Event::MouseButtonPressed:
+				//another click happened.. is it within time?
+				if(m_doubleClickActivated) {
+					if(m_doubleClickDiff < 0) {
+						//it was not within time.. double click expired
+						m_doubleClickDiff = m_doubleClickTime;
+						m_doubleClickActivated = false;
+					} else {
+						child->OnDoubleClick(event);
+						//reset double click
+						m_doubleClickActivated = false;
+						m_doubleClickDiff = m_doubleClickTime;
+					}
+				} else { //first click.. activate the double click
+					m_doubleClickActivated = true;
+					m_doubleClickDiff = m_doubleClickTime;
+				}
+				break;
+			case sf::Event::MouseButtonReleased:
+				//focus gets the release even if it's not colliding, but then
+				//it loses focus(the handlers might have killed it already)
+				if(m_focus && !m_focus->IsCollision(Rect((int)pos.x,(int)pos.y,1,1))) {
+					m_focus->_LoseFocus(false);
+					m_focus = NULL;
+				}
+				break;
+			case sf::Event::MouseMoved:
+				//the parents see the moves after their hovered child
+				OnEvent(event);
+				break;
+			default:
+				break;
+		}
+	}
 
-		//now update child widgets 
-		for(WidgetList::iterator i = m_widgets.begin(); i!= m_widgets.end(); i++){
-			i->second->_HandleEvents();
-		}	
+	bool Widget::OnCaptureEvent( Widget* child, sf::Event* event )
+	{
+		return false;
 	}
 
 	void Widget::SetFocus( Widget* widget )
 	{
+		MarkDirty();
 		if(m_focus) {
 			m_focus->m_isFocus = false;
 			m_focus->_HandleOnFocusLost();
@@ -747,6 +1040,9 @@ namespace gui {
 		}
 		if(!widget) return;
 
+		//bring it in front of its siblings
+		m_widgets.raise(widget);
+
 		m_focus = widget;
 		widget->m_isFocus = true;
 		widget->OnFocus();
@@ -771,8 +1067,8 @@ namespace gui {
 			OnHover();
 
 		for(WidgetList::iterator it = m_widgets.begin();it!=m_widgets.end();it++) {
-			if(it->second->IsCollision(m_rect)) {
-				it->second->_HandleOnHover(pos);
+			if((*it)->IsCollision(m_rect)) {
+				(*it)->_HandleOnHover(pos);
 				break; //only one widget can have a hover event..
 			}
 		}
@@ -783,7 +1079,7 @@ namespace gui {
 		//send the focus-lost event to self and child widgets
 		OnFocusLost();
 		for(WidgetList::iterator it = m_widgets.begin();it!=m_widgets.end();it++) {
-			it->second->OnFocusLost();
+			(*it)->OnFocusLost();
 		}
 	}
 
@@ -792,10 +1088,12 @@ namespace gui {
 		//changing themes doesn't matter if the widget has a individual theme
 		if(m_individualTheme || !s_gui->GetTheme()) return;
 
+		MarkDirty();
+		Repaint();
 		InitGraphics();
 
 		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			it->second->ReloadTheme();
+			(*it)->ReloadTheme();
 		}
 
 	}
@@ -804,6 +1102,8 @@ namespace gui {
 	{
 		if(!m_allowSave) return;
 
+		SavePosition();
+
 		//save my properties
 		if(m_settings.size()) {
 			TiXmlElement* elem = new TiXmlElement("property");
@@ -814,7 +1114,7 @@ namespace gui {
 		//now save all my child widgets
 		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) 
 		{
-			it->second->SaveLayout(node);
+			(*it)->SaveLayout(node);
 		}
 
 	}
@@ -889,6 +1189,7 @@ namespace gui {
 
 	void Widget::_LoseFocus(bool forgetFocus /* = true */)
 	{
+		MarkDirty();
 		OnFocusLost();
 		//you're no longer focus
 		m_isFocus = false;
@@ -898,8 +1199,8 @@ namespace gui {
 
 		//repeat for all child widgets
 		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			if(it->second->IsFocus())
-				it->second->_LoseFocus();
+			if((*it)->IsFocus())
+				(*it)->_LoseFocus();
 		}
 	}
 
@@ -929,51 +1230,60 @@ namespace gui {
 
 	void Widget::OnResize(const Rect& oldRect)
 	{
-		m_mediator.PostEvent(new gui::OnResize(this,oldRect));
+		m_mediator.PostEvent<gui::OnResize>(this,oldRect);
 	}
 
 	void Widget::OnMove(const Rect& oldRect)
 	{
-		m_mediator.PostEvent(new gui::OnMove(this,oldRect));
+		//the event is only created if someone listens
+		m_mediator.PostEvent<gui::OnMove>(this,oldRect);
 	}
 
 	void Widget::OnShow()
 	{
-		m_mediator.PostEvent(new gui::OnShow(this));
+		m_mediator.PostEvent<gui::OnShow>(this);
 	}
 
 	void Widget::OnHide()
 	{
-		m_mediator.PostEvent(new gui::OnHide(this));
+		m_mediator.PostEvent<gui::OnHide>(this);
 	}
 
 	void Widget::OnDestroy()
 	{
-		m_mediator.PostEvent(new gui::OnDestroy(this));
+		m_mediator.PostEvent<gui::OnDestroy>(this);
 	}
 
 	void Widget::OnHover()
 	{
+		MarkDirty();
+		Repaint();
 		m_hovering = true;
-		m_mediator.PostEvent(new gui::OnHover(this));
+		m_mediator.PostEvent<gui::OnHover>(this);
 	}
 
 	void Widget::OnHoverLost()
 	{
 // 		glEnable(GL_SCISSOR_TEST);
 // 		glDisable(GL_SCISSOR_TEST);
+		MarkDirty();
+		Repaint();
 		m_hovering = false;
-		m_mediator.PostEvent(new gui::OnHoverLost(this));
+		m_mediator.PostEvent<gui::OnHoverLost>(this);
 	}
 
 	void Widget::OnFocus()
 	{
-		m_mediator.PostEvent(new gui::OnFocus((gui::Widget*)this));
+		MarkDirty();
+		Repaint();
+		m_mediator.PostEvent<gui::OnFocus>(this);
 	}
 
 	void Widget::OnFocusLost()
 	{
-		m_mediator.PostEvent(new gui::OnFocusLost(this));
+		MarkDirty();
+		Repaint();
+		m_mediator.PostEvent<gui::OnFocusLost>(this);
 	}
 
 	bool Widget::IsHovering() const
@@ -983,12 +1293,22 @@ namespace gui {
 
 	bool Widget::IsCollision( const Rect& rect ) const
 	{
-		return m_visible ? gui::IsCollision(m_rect,rect) : false;
+		return m_visible ? gui::IsCollision(GetRect(),rect) : false;
 	}
 
 	bool Widget::IsCollision( const Rect& rect, sf::Vector2f& normal ) const
 	{
-		return m_visible ? gui::IsCollision(m_rect,rect, normal) : false;
+		return m_visible ? gui::IsCollision(GetRect(),rect, normal) : false;
+	}
+
+	void Widget::SavePosition() const
+	{
+		//the saved position may be out of date if a parent moved
+		if(!m_settings.HasInt32Value("posx") && !m_settings.HasInt32Value("posy")) return;
+
+		const Rect& rect = GetRect();
+		m_settings.SetInt32Value("posx",rect.x);
+		m_settings.SetInt32Value("posy",rect.y);
 	}
 
 	void Widget::SaveUI( TiXmlNode* node ) const
@@ -1002,6 +1322,8 @@ namespace gui {
 		e->SetAttribute("type", (int)GetType());
 		node->LinkEndChild(e);
 
+		SavePosition();
+
 		if(m_mediator.IsActive()) {
 			c = new TiXmlComment("Internal listeners. Usable inside specific widgets");
 			e->LinkEndChild(c);
@@ -1028,7 +1350,7 @@ namespace gui {
 		//now save all my child widgets
 		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) 
 		{
-			it->second->SaveUI(e);
+			(*it)->SaveUI(e);
 		}
 
 	}
@@ -1058,25 +1380,36 @@ namespace gui {
 		m_allowSave = flag;
 	}
 
-	void Widget::ResolveChildCollisions()
+	void Widget::ResolveChildCollisions( Widget* moved )
 	{
-		//resolve solid collisions between your child widgets
+		//the pushed widgets would resolve their own collisions again
+		if(m_resolvingCollisions || !m_widgets.contains(moved)) return;
+		m_resolvingCollisions = true;
+
+		//broadphase: only the children overlapping the moved one
+		std::vector<Widget*> candidates;
+		m_spatialIndex.QueryRect(moved->GetLocalRect(),candidates);
+
+		//resolve solid collisions between the moved child and its siblings
 		sf::Vector2f normal;
-		for(WidgetList::iterator it = m_widgets.begin(); 
-			it != m_widgets.end(); it++) 
-		{
-			for(WidgetList::iterator i = m_widgets.begin();
-				i != m_widgets.end(); i++) 
-			{
-				if(!i->second->IsSolid() || it == i) continue;
-
-				if(it->second->IsCollision(i->second->GetRect(),normal)) {
-					int xpos = it->second->GetRect().x + (int)normal.x;
-					int ypos = it->second->GetRect().y + (int)normal.y;
-					it->second->SetPos(xpos, ypos,true);
-				}
+		for(uint32 i=0; i<candidates.size(); i++) {
+			Widget* other = candidates[i];
+			if(other == moved) continue;
+
+			//the moved widget can't go through a solid widget
+			if(other->IsSolid() && moved->IsCollision(other->GetRect(),normal)) {
+				int xpos = moved->GetRect().x + (int)normal.x;
+				int ypos = moved->GetRect().y + (int)normal.y;
+				moved->SetPos(xpos, ypos,true);
+			}
+			//a solid widget pushes away the ones it lands on
+			if(moved->IsSolid() && other->IsCollision(moved->GetRect(),normal)) {
+				int xpos = other->GetRect().x + (int)normal.x;
+				int ypos = other->GetRect().y + (int)normal.y;
+				other->SetPos(xpos, ypos,true);
 			}
 		}
+		m_resolvingCollisions = false;
 	}
 
 	sf::RenderWindow* Widget::GetWindow() const
@@ -1142,7 +1475,7 @@ namespace gui {
 		pos.SetText(s.str());
 		pos.SetColor(sf::Color(255,0,0));
 		pos.SetPosition(drag->GetCurrentPos());
-		s_gui->GetWindow().Draw(pos);
+		s_gui->GetRenderBackend().Draw(pos);
 		return true;
 	}
 
@@ -1162,31 +1495,18 @@ namespace gui {
 			if(drag->GetCurrentFocus() != this) {
 				//if it's been moved on the gui
 				if(!drag->GetCurrentFocus()) {
-					//order matters, because when you add the widget the m_id changes!
-					RemoveWidget(target);	  //remove it first
-					s_gui->AddWidget(target); //then add it to someone else
+					//the gui takes it over from us
+					s_gui->AddWidget(target);
 				} else {
 					//it's inside another widget.. 
 					Widget* parent = drag->GetCurrentFocus();
-					//parent->AddWidget(target);
 
-					//m_id of target will likely change if the drop is successful and the parent changes
-					uint32 old_id = drag->GetTarget()->GetId();
 					if(!parent->HandleDragDrop(drag)) {
 						//move to the original drag position.. since drag failed
 						drag->GetTarget()->SetPos(drag->GetStartPos(),true);
-					} else {
-
-						//remember the new id received
-						uint32 new_id = drag->GetTarget()->GetId();
-
-						//need this to be able to remove the widget from management
-						drag->GetTarget()->SetId(old_id);
+					} else if(target->GetParent() == this) {
+						//the new parent didn't take it over, so stop managing it
 						RemoveWidget(target);
-
-						//restore the new id received
-						drag->GetTarget()->SetId(new_id);
-
 					}
 					return true;
 				}
@@ -1201,11 +1521,16 @@ namespace gui {
 	Widget* Widget::GetWidgetAt( int x, int y ) const
 	{
 		Rect rect = Rect(x,y,1,1);
-		for(WidgetList::const_iterator it = m_widgets.begin(); 
-			it != m_widgets.end(); it++) 
-		{
-			if(it->second->IsCollision(rect)) {
-				return it->second;
+		std::vector<Widget*> candidates;
+
+		//the children are indexed relative to this widget
+		const Rect& self = GetRect();
+		m_spatialIndex.QueryPoint(x-self.x,y-self.y,candidates);
+
+		//the candidates are sorted front to back
+		for(uint32 i=0; i<candidates.size(); i++) {
+			if(candidates[i]->IsCollision(rect)) {
+				return candidates[i];
 			}
 		}
 		return NULL;	
@@ -1236,8 +1561,8 @@ namespace gui {
 			m_dropFlags = drag->GetDragFlags();
 			SetPos(drag->GetCurrentPos(), drag->GetForcedMove());
 			
-			//create the drag event.. you shouldn't really create a new drag event every time you move the mouse :|
-			m_mediator.PostEvent(new gui::OnDrag(this,drag));
+			//the drag event only gets created if someone listens, it comes from the event pool
+			m_mediator.PostEvent<gui::OnDrag>(this,drag);
 
 		m_dropFlags = temp;
 
@@ -1246,20 +1571,17 @@ namespace gui {
 
 	Widget* Widget::QueryWidget( const std::string& path ) const
 	{
-		std::vector<std::string> temp;
-		ExtractPath(path,temp);
-
-		if(!temp.size()) return NULL;
+		return QueryWidget(WidgetPath(path));
+	}
 
-		Widget* cur = NULL;
-		for(uint32 i=0; i<temp.size(); i++) {
-			cur = FindChildByName(temp[i]);
-			if(!cur) {
-				error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", path.c_str(),temp[i]);
-				return NULL;
-			}
+	Widget* Widget::QueryWidget( const WidgetPath& path ) const
+	{
+		Widget* widget = path.Resolve(this);
+		if(!widget && !path.IsEmpty()) {
+			error_log("Unable to complete query \"%s\". Widget \"%s\" not found!", 
+				path.GetPath().c_str(), path.GetMissingSegment(this).c_str());
 		}
-		return cur;
+		return widget;
 	}
 
 
@@ -1272,10 +1594,15 @@ namespace gui {
 	{
 		OnDestroy();
 		m_dead = true;
+		MarkDirty();
+		Repaint();
 
+		//the handle stays valid until the widget is freed, so the events it
+		//still has queued can tell the listeners which widget died. Focus, 
+		//hover and drags check IsDead() instead
 		//kill all contained widgets!
 		for(WidgetList::iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			it->second->Kill();
+			(*it)->Kill();
 		}
 	}
 
@@ -1303,13 +1630,44 @@ namespace gui {
 	void Widget::StartClipping() const
 	{
 		if(!s_gui) return;
-		glEnable(GL_SCISSOR_TEST);
-		glScissor(m_clipRect.x, m_clipRect.y, m_clipRect.w, m_clipRect.h); 
+		s_gui->GetDrawList().PushClip(m_clipRect);
 	}
 
 	void Widget::StopClipping() const
 	{
-		glDisable(GL_SCISSOR_TEST);
+		if(!s_gui) return;
+		s_gui->GetDrawList().PopClip();
+	}
+
+	bool Widget::UpdateVisibleRect( const Rect& clip ) const
+	{
+		if(!m_visible) {
+			m_visibleRect = Rect();
+			return false;
+		}
+		m_visibleRect = GetIntersection(m_rect,clip);
+		return m_visibleRect.w != 0;
+	}
+
+	gui::Rect Widget::GetChildClipRect() const
+	{
+		return m_rect;
+	}
+
+	gui::Rect Widget::GetOpaqueRect() const
+	{
+		//the background has to hide everything behind it, images may not
+		if(!m_visible || !m_mainVisible || m_transparency != 255 || m_sprite) return Rect();
+		if(m_shape.GetNbPoints() < 3 || m_shape.GetColor().a != 255) return Rect();
+		for(unsigned int i=0; i<m_shape.GetNbPoints(); i++) {
+			if(m_shape.GetPointColor(i).a != 255) return Rect();
+		}
+		return m_rect;
+	}
+
+	const gui::Rect& Widget::GetVisibleRect() const
+	{
+		return m_visibleRect;
 	}
 
 	bool Widget::IsVisible() const
@@ -1336,6 +1694,7 @@ namespace gui {
 	//returns the visible rect --view based!)
 	gui::Rect Widget::NormalizeClipAreaView() const
 	{
+		ValidateTransform();
 		if(!s_gui || !m_clipRect) return Rect();
 
 		Rect temp = m_clipRect;
@@ -1357,6 +1716,7 @@ namespace gui {
 	//returns the visible rect as seen on screen(coords are screen..not view based!)
 	gui::Rect Widget::NormalizeClipArea() const
 	{
+		ValidateTransform();
 		if(!s_gui || !m_clipRect) return Rect();
 
 		Rect temp = m_clipRect;
@@ -1419,9 +1779,9 @@ namespace gui {
 		for(WidgetList::iterator it = m_widgets.begin(); 
 			it != m_widgets.end(); it++) 
 		{
-			if(widget == it->second) {	//if your child is the wanted one.. you contain it!
+			if(widget == (*it)) {	//if your child is the wanted one.. you contain it!
 				return true;
-			} else if(it->second->ContainsWidget(widget)) { //else if your child contains it.. you contain it as well!
+			} else if((*it)->ContainsWidget(widget)) { //else if your child contains it.. you contain it as well!
 				return true;
 			}
 		}
@@ -1453,7 +1813,7 @@ namespace gui {
 
 	void Widget::OnDoubleClick( sf::Event* event )
 	{
-		m_mediator.PostEvent(new gui::OnDoubleClick(this));
+		m_mediator.PostEvent<gui::OnDoubleClick>(this);
 	}
 
 	void Widget::FreeDeadWidgets()
@@ -1461,18 +1821,9 @@ namespace gui {
 
 		//free the dead widgets
 		for(uint32 i=0;i<m_freeWidgets.size(); i++) {
-			uint32 guid = m_freeWidgets[i]->GetId();
-			WidgetList::iterator it = m_widgets.find(guid);
-			if(it != m_widgets.end()) {
-				Widget* widget = it->second;
-
-				//if the dying widget contains the current focus.. null it!
-				if(widget->ContainsWidget(m_focus)) {
-					m_focus = NULL;
-				} 
-				if(widget->ContainsWidget(m_hoverTarget)) {
-					m_hoverTarget = NULL;
-				}
+			Widget* widget = m_freeWidgets[i];
+			if(m_widgets.contains(widget)) {
+				//removing it also clears the focus/hover if the widget had them
 				RemoveWidget(widget);
 				delete widget;
 			} else {
@@ -1482,21 +1833,4 @@ namespace gui {
 
 		m_freeWidgets.clear();
 	}
-
-// 	Rect Widget::GetSmallestParentClipRect()
-// 	{
-// 		Rect temp = m_rect;
-// 		Widget* current = GetParent();
-// 		while(current) {
-// 			Rect& prect = current->NormalizeClipAreaView();
-// 
-// 			temp.x = std::max(temp.x,prect.x);
-// 			temp.y = std::max(temp.y,prect.y);
-// 			temp.w = std::min(temp.w,prect.w);
-// 			temp.h = std::min(temp.h,prect.h);
-// 
-// 			current = current->GetParent();
-// 		}
-// 		return temp;
-// 	}
 }
@@ -0,0 +1,83 @@
+#include "../include/gui/WidgetHandle.hpp"
+#include "../include/gui/Widget.hpp"
+
+namespace gui
+{
+	std::vector<WidgetHandle::Slot> WidgetHandle::s_slots;
+	std::vector<uint32> WidgetHandle::s_freeSlots;
+
+	WidgetHandle::WidgetHandle() : m_slot(0), m_generation(0)
+	{
+
+	}
+
+	WidgetHandle::WidgetHandle( const Widget* widget ) : m_slot(0), m_generation(0)
+	{
+		if(widget) *this = widget->GetHandle();
+	}
+
+	Widget* WidgetHandle::Get() const
+	{
+		if(m_slot >= s_slots.size()) return NULL;
+
+		const Slot& slot = s_slots[m_slot];
+		return slot.generation == m_generation ? slot.widget : NULL;
+	}
+
+	bool WidgetHandle::IsValid() const
+	{
+		return Get() != NULL;
+	}
+
+	void WidgetHandle::Reset()
+	{
+		m_slot = 0;
+		m_generation = 0;
+	}
+
+	gui::uint32 WidgetHandle::GetSlot() const
+	{
+		return m_slot;
+	}
+
+	gui::uint32 WidgetHandle::GetGeneration() const
+	{
+		return m_generation;
+	}
+
+	WidgetHandle WidgetHandle::Acquire( Widget* widget )
+	{
+		WidgetHandle handle;
+		if(!widget) return handle;
+
+		if(!s_freeSlots.empty()) {
+			handle.m_slot = s_freeSlots.back();
+			s_freeSlots.pop_back();
+		} else {
+			Slot slot;
+			slot.widget = NULL;
+			slot.generation = 0;
+			handle.m_slot = s_slots.size();
+			s_slots.push_back(slot);
+		}
+		Slot& slot = s_slots[handle.m_slot];
+
+		//skip 0 so default handles never match a slot
+		if(++slot.generation == 0) ++slot.generation;
+		slot.widget = widget;
+
+		handle.m_generation = slot.generation;
+		return handle;
+	}
+
+	void WidgetHandle::Release( const WidgetHandle& handle )
+	{
+		//already released, or not a handle from Acquire()
+		if(!handle.IsValid()) return;
+
+		Slot& slot = s_slots[handle.m_slot];
+		slot.widget = NULL;
+		if(++slot.generation == 0) ++slot.generation;
+		s_freeSlots.push_back(handle.m_slot);
+	}
+}
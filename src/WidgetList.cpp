@@ -0,0 +1,181 @@
+#include "../include/gui/WidgetList.hpp"
+#include "../include/gui/Widget.hpp"
+#include "../include/gui/Debug.hpp"
+
+namespace gui
+{
+	//z-orders start in the middle so widgets can be pushed on both sides
+	static const uint32 Z_ORDER_START = 0x80000000;
+
+	WidgetListNode::WidgetListNode( Widget* widget ) :
+		self(widget), prev(NULL), next(NULL), list(NULL), zOrder(0)
+	{
+
+	}
+
+	WidgetList::WidgetList() : m_bottom(NULL), m_top(NULL), m_size(0),
+		m_topZ(Z_ORDER_START), m_bottomZ(Z_ORDER_START)
+	{
+
+	}
+
+	WidgetList::~WidgetList()
+	{
+		clear();
+	}
+
+	Widget* WidgetList::top() const
+	{
+		return m_top ? m_top->self : NULL;
+	}
+
+	Widget* WidgetList::bottom() const
+	{
+		return m_bottom ? m_bottom->self : NULL;
+	}
+
+	void WidgetList::push_front( Widget* widget )
+	{
+		if(!widget) return;
+		WidgetListNode* node = &widget->m_zNode;
+
+		if(node->list) {
+			error_log("Widget \"%s\" is already part of a list!", widget->GetName().c_str());
+			return;
+		}
+		LinkBottom(node);
+		m_size++;
+	}
+
+	void WidgetList::push_back( Widget* widget )
+	{
+		if(!widget) return;
+		WidgetListNode* node = &widget->m_zNode;
+
+		if(node->list) {
+			error_log("Widget \"%s\" is already part of a list!", widget->GetName().c_str());
+			return;
+		}
+		LinkTop(node);
+		m_size++;
+	}
+
+	void WidgetList::raise( Widget* widget )
+	{
+		if(!contains(widget)) return;
+		WidgetListNode* node = &widget->m_zNode;
+
+		//already in front
+		if(node == m_top) return;
+
+		Unlink(node);
+		LinkTop(node);
+	}
+
+	void WidgetList::lower( Widget* widget )
+	{
+		if(!contains(widget)) return;
+		WidgetListNode* node = &widget->m_zNode;
+
+		//already behind everyone
+		if(node == m_bottom) return;
+
+		Unlink(node);
+		LinkBottom(node);
+	}
+
+	void WidgetList::remove( Widget* widget )
+	{
+		if(!contains(widget)) return;
+
+		Unlink(&widget->m_zNode);
+		m_size--;
+	}
+
+	bool WidgetList::contains( const Widget* widget ) const
+	{
+		return widget && widget->m_zNode.list == this;
+	}
+
+	void WidgetList::clear()
+	{
+		WidgetListNode* node = m_bottom;
+		while(node) {
+			WidgetListNode* next = node->next;
+			node->prev = node->next = NULL;
+			node->list = NULL;
+			node = next;
+		}
+		m_bottom = m_top = NULL;
+		m_size = 0;
+		m_topZ = m_bottomZ = Z_ORDER_START;
+	}
+
+	void WidgetList::LinkTop( WidgetListNode* node )
+	{
+		if(m_topZ == 0xFFFFFFFF) Renumber();
+
+		node->list = this;
+		node->prev = m_top;
+		node->next = NULL;
+		node->zOrder = m_top ? ++m_topZ : m_topZ;
+
+		if(m_top) {
+			m_top->next = node;
+		} else {
+			m_bottom = node;
+			m_bottomZ = m_topZ;
+		}
+		m_top = node;
+	}
+
+	void WidgetList::LinkBottom( WidgetListNode* node )
+	{
+		if(m_bottomZ == 0) Renumber();
+
+		node->list = this;
+		node->prev = NULL;
+		node->next = m_bottom;
+		node->zOrder = m_bottom ? --m_bottomZ : m_bottomZ;
+
+		if(m_bottom) {
+			m_bottom->prev = node;
+		} else {
+			m_top = node;
+			m_topZ = m_bottomZ;
+		}
+		m_bottom = node;
+	}
+
+	void WidgetList::Unlink( WidgetListNode* node )
+	{
+		if(node->prev) {
+			node->prev->next = node->next;
+		} else {
+			m_bottom = node->next;
+		}
+		if(node->next) {
+			node->next->prev = node->prev;
+		} else {
+			m_top = node->prev;
+		}
+		node->prev = node->next = NULL;
+		node->list = NULL;
+
+		//keep the counters tight, so they only wrap after a very long time
+		if(m_top) m_topZ = m_top->zOrder;
+		if(m_bottom) m_bottomZ = m_bottom->zOrder;
+		if(!m_top) m_topZ = m_bottomZ = Z_ORDER_START;
+	}
+
+	void WidgetList::Renumber()
+	{
+		//very rare: the z-orders reached a limit, so spread them again
+		uint32 z = Z_ORDER_START - m_size / 2;
+		for(WidgetListNode* node = m_bottom; node; node = node->next) {
+			node->zOrder = z++;
+		}
+		m_bottomZ = m_bottom ? m_bottom->zOrder : Z_ORDER_START;
+		m_topZ = m_top ? m_top->zOrder : Z_ORDER_START;
+	}
+}
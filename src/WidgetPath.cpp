@@ -0,0 +1,136 @@
+#include "../include/gui/WidgetPath.hpp"
+#include "../include/gui/Widget.hpp"
+#include "../include/gui/GuiManager.hpp"
+#include "../include/gui/SymbolTable.hpp"
+
+namespace gui
+{
+	uint32 WidgetPath::s_stamp = 1;
+
+	WidgetPath::WidgetPath() : m_cached(NULL), m_cachedRoot(NULL), m_cachedStamp(0)
+	{
+
+	}
+
+	WidgetPath::WidgetPath( const std::string& path ) :
+		m_cached(NULL), m_cachedRoot(NULL), m_cachedStamp(0)
+	{
+		Compile(path);
+	}
+
+	WidgetPath::WidgetPath( const char* path ) :
+		m_cached(NULL), m_cachedRoot(NULL), m_cachedStamp(0)
+	{
+		Compile(path ? path : "");
+	}
+
+	void WidgetPath::Compile( const std::string& path )
+	{
+		m_path = path;
+		m_segments.clear();
+		m_symbols.clear();
+		ExtractPath(path,m_segments);
+
+		for(uint32 i=0; i<m_segments.size(); i++) {
+			m_symbols.push_back(SymbolTable::Intern(m_segments[i]));
+		}
+
+		m_cached = NULL;
+		m_cachedRoot = NULL;
+		m_cachedStamp = 0;
+	}
+
+	Widget* WidgetPath::Resolve( const GuiManager* gui ) const
+	{
+		if(!gui || m_segments.empty()) return NULL;
+		if(IsCached(gui)) return m_cached;
+
+		return Cache(gui, ResolveFrom(gui->GetWidgetBySymbol(m_symbols[0])));
+	}
+
+	Widget* WidgetPath::Resolve( const Widget* root ) const
+	{
+		if(!root || m_segments.empty()) return NULL;
+		if(IsCached(root)) return m_cached;
+
+		return Cache(root, ResolveFrom(root->FindChildBySymbol(m_symbols[0])));
+	}
+
+	Widget* WidgetPath::ResolveFrom( Widget* first ) const
+	{
+		Widget* current = first;
+		for(uint32 i=1; current && i<m_symbols.size(); i++) {
+			current = current->FindChildBySymbol(m_symbols[i]);
+		}
+		return current;
+	}
+
+	const std::string& WidgetPath::GetMissingSegment( const GuiManager* gui ) const
+	{
+		if(!gui || m_segments.empty()) return m_path;
+
+		return FindMissingFrom(gui->GetWidgetBySymbol(m_symbols[0]));
+	}
+
+	const std::string& WidgetPath::GetMissingSegment( const Widget* root ) const
+	{
+		if(!root || m_segments.empty()) return m_path;
+
+		return FindMissingFrom(root->FindChildBySymbol(m_symbols[0]));
+	}
+
+	const std::string& WidgetPath::FindMissingFrom( Widget* first ) const
+	{
+		if(!first) return m_segments[0];
+
+		Widget* current = first;
+		for(uint32 i=1; i<m_symbols.size(); i++) {
+			current = current->FindChildBySymbol(m_symbols[i]);
+			if(!current) return m_segments[i];
+		}
+		return m_path;
+	}
+
+	bool WidgetPath::IsCached( const void* root ) const
+	{
+		return (m_cachedStamp == s_stamp && m_cachedRoot == root);
+	}
+
+	Widget* WidgetPath::Cache( const void* root, Widget* result ) const
+	{
+		m_cached = result;
+		m_cachedRoot = root;
+		m_cachedStamp = s_stamp;
+		return result;
+	}
+
+	const std::string& WidgetPath::GetPath() const
+	{
+		return m_path;
+	}
+
+	const std::string& WidgetPath::GetSegment( uint32 index ) const
+	{
+		return m_segments[index];
+	}
+
+	gui::uint32 WidgetPath::GetSegmentCount() const
+	{
+		return m_segments.size();
+	}
+
+	bool WidgetPath::IsEmpty() const
+	{
+		return m_segments.empty();
+	}
+
+	void WidgetPath::Invalidate()
+	{
+		++s_stamp;
+	}
+
+	gui::uint32 WidgetPath::GetStamp()
+	{
+		return s_stamp;
+	}
+}
@@ -25,6 +25,8 @@ namespace gui
 		SetTitleName(title);
 		AddWidget(titlebar);
 
+		//one drag event per frame is enough to follow the mouse
+		m_mediator.SetCoalescing(true);
 		m_mediator.Connect(titlebar,"default",gui::events::OnDrag,false);
 		m_mediator.Connect(titlebar,"default",events::OnDoubleClick,false);
 
@@ -37,7 +39,9 @@ namespace gui
 		while(Event* e = m_mediator.GetEvent()) {
 			if(e->GetType() == sf::Event::MouseButtonPressed) {
 				WidgetEvent* w = (WidgetEvent*)e;
-				if(w->GetWidget()->GetName() == "close") {
+				if(!w->GetWidget()) {
+					continue;
+				} else if(w->GetWidget()->GetName() == "close") {
 					Kill();
 					debug_log("Closing window \"%s\"",m_name.c_str());
 				} else if(w->GetWidget()->GetName() == "min") {
@@ -79,14 +83,27 @@ namespace gui
 		return true;
 	}
 
+	gui::Rect Window::GetChildClipRect() const
+	{
+		//only the title bar shows while minimized, same height as the clip area
+		Rect rect = m_rect;
+		if(m_minimized) rect.h = std::min(rect.h,GetTitleBarHeight());
+		return rect;
+	}
+
+	gui::Rect Window::GetOpaqueRect() const
+	{
+		//the background is clipped like the children
+		return GetIntersection(Widget::GetOpaqueRect(),GetChildClipRect());
+	}
+
 	void Window::UpdateClipArea()
 	{
 		if(!s_gui) return;
 
 		if(m_minimized) {
 			int temp = m_rect.h;
-			//todo: hardcoded minimize value here:
-			m_rect.h = 15;
+			m_rect.h = GetTitleBarHeight();
 			Widget::UpdateClipArea();
 			m_rect.h = temp;
 		} else {
@@ -99,17 +116,11 @@ namespace gui
 		if(!m_visible) return;
 
 		StartClipping();
-			s_gui->GetWindow().Draw(m_shape);
+			s_gui->GetDrawList().Add(m_shape);
 		StopClipping();
 		
 		//also draw children if any
-		for(WidgetList::const_iterator it = m_widgets.begin(); it != m_widgets.end(); it++) {
-			//don't draw outside parent's rect
-			StartClipping();
-				it->second->Draw();
-			StopClipping();
-		}
-
+		DrawChildren();
 	}
 
 	void Window::ReloadSettings()
@@ -125,6 +136,13 @@ namespace gui
 
 	}
 
+	int Window::GetTitleBarHeight() const
+	{
+		//nothing shows while minimized without a title bar
+		Widget* titlebar = FindChildByName("my_titlebar");
+		return titlebar ? titlebar->GetRect().h : 0;
+	}
+
 	void Window::SetTitleName( const std::string& title_name )
 	{
 		TitleBar* titlebar = dynamic_cast<TitleBar*>(this->FindChildByName("my_titlebar"));
@@ -162,6 +180,8 @@ namespace gui
 		m_minimized = ! m_minimized;
 
 		UpdateClipArea();
+		MarkDirty();
+		Repaint();
 		debug_log("Minimizing window \"%s\"",m_name.c_str());
 	}
 